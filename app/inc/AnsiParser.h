@@ -0,0 +1,154 @@
+#ifndef ANSI_PARSER_H
+#define ANSI_PARSER_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// 颜色按ImGui的IM_COL32布局打包(0xAABBGGRR)；alpha为0的kAnsiDefaultColor表示未设置颜色，由显示端决定
+constexpr uint32_t kAnsiDefaultColor = 0;
+
+constexpr uint32_t AnsiPackColor(uint32_t r, uint32_t g, uint32_t b) {
+    return 0xFF000000u | (b << 16) | (g << 8) | r;
+}
+
+// xterm 256色调色板：0-15为基本色，16-231为6x6x6色立方，232-255为灰阶
+constexpr std::array<uint32_t, 256> MakeAnsiPalette() {
+    std::array<uint32_t, 256> palette{};
+    constexpr uint32_t basic[16][3] = {
+        {0, 0, 0}, {204, 0, 0}, {0, 204, 0}, {204, 204, 0},
+        {0, 0, 204}, {204, 0, 204}, {0, 204, 204}, {204, 204, 204},
+        {128, 128, 128}, {255, 0, 0}, {0, 255, 0}, {255, 255, 0},
+        {0, 0, 255}, {255, 0, 255}, {0, 255, 255}, {255, 255, 255},
+    };
+    for (int i = 0; i < 16; ++i) {
+        palette[i] = AnsiPackColor(basic[i][0], basic[i][1], basic[i][2]);
+    }
+    constexpr uint32_t levels[6] = {0, 95, 135, 175, 215, 255};
+    for (int i = 0; i < 216; ++i) {
+        palette[16 + i] = AnsiPackColor(levels[i / 36], levels[(i / 6) % 6], levels[i % 6]);
+    }
+    for (int i = 0; i < 24; ++i) {
+        const uint32_t gray = 8 + 10 * static_cast<uint32_t>(i);
+        palette[232 + i] = AnsiPackColor(gray, gray, gray);
+    }
+    return palette;
+}
+
+inline constexpr std::array<uint32_t, 256> kAnsiPalette = MakeAnsiPalette();
+
+// 一段可见文本：原始行中的位置和颜色
+struct AnsiRun {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t color;
+};
+
+// SGR(Select Graphic Rendition)样式状态
+struct AnsiStyle {
+    enum class ColorKind : uint8_t { Default, Indexed, Rgb };
+
+    ColorKind fg_kind = ColorKind::Default;
+    uint8_t fg_index = 0;
+    bool bold = false;
+    uint32_t fg_rgb = 0;
+
+    // 当前前景色；粗体使基本色0-7变亮
+    uint32_t Color() const;
+    // 应用一条SGR序列的参数(空参数按0处理)
+    // subparams第k位为1表示params[k]前面是冒号，即前一个参数的子参数(ITU T.416格式，如38:2::r:g:b)
+    void Apply(const uint16_t* params, size_t count, uint32_t subparams = 0);
+};
+
+// 单遍ANSI转义序列状态机，不分配内存
+// 可见文本按颜色切成连续段，每段调用一次on_run(const AnsiRun&)；SGR序列改变颜色，
+// 其余CSI序列、OSC序列和两字节ESC序列直接跳过。每行从默认样式开始
+template<typename Fn>
+void ParseAnsiRuns(std::string_view line, Fn&& on_run) {
+    const char* const base = line.data();
+    const size_t size = line.size();
+
+    // 没有ESC的行(绝大多数)整体作为一段
+    if (!memchr(base, '\033', size)) {
+        if (size > 0) on_run(AnsiRun{0, static_cast<uint32_t>(size), kAnsiDefaultColor});
+        return;
+    }
+
+    constexpr size_t kMaxParams = 32;
+    AnsiStyle style;
+    uint32_t color = kAnsiDefaultColor;
+    size_t text_begin = 0;
+    size_t i = 0;
+
+    auto flush = [&](size_t end) {
+        if (end > text_begin) {
+            on_run(AnsiRun{static_cast<uint32_t>(text_begin), static_cast<uint32_t>(end - text_begin), color});
+        }
+    };
+
+    while (i < size) {
+        const auto* esc = static_cast<const char*>(memchr(base + i, '\033', size - i));
+        if (!esc) break;
+        const size_t esc_pos = static_cast<size_t>(esc - base);
+        flush(esc_pos);
+
+        size_t p = esc_pos + 1;
+        if (p >= size) {
+            // 行尾孤立的ESC
+            i = text_begin = size;
+            break;
+        }
+
+        const char kind = base[p++];
+        if (kind >= 0x20 && kind <= 0x2F) {
+            // nF序列(如ESC ( B)：中间字节之后跟一个终止字节
+            while (p < size && base[p] >= 0x20 && base[p] <= 0x2F) ++p;
+            if (p < size) ++p;
+        } else if (kind == '[') {
+            // CSI：参数字节0x30-0x3F，中间字节0x20-0x2F，终止字节0x40-0x7E
+            uint16_t params[kMaxParams];
+            size_t count = 0;
+            uint32_t subparams = 0;     // 冒号后的参数，见AnsiStyle::Apply
+            uint32_t value = 0;
+            bool sgr_params = true;     // 只含数字和分隔符
+            while (p < size) {
+                const auto c = static_cast<unsigned char>(base[p]);
+                if (c >= '0' && c <= '9') {
+                    value = value * 10 + (c - '0');
+                    if (value > 0xFFFF) value = 0xFFFF;
+                } else if (c == ';' || c == ':') {
+                    if (count < kMaxParams) params[count++] = static_cast<uint16_t>(value);
+                    if (c == ':' && count < kMaxParams) subparams |= uint32_t(1) << count;
+                    value = 0;
+                } else if (c >= 0x20 && c <= 0x3F) {
+                    sgr_params = false;
+                } else {
+                    break;
+                }
+                ++p;
+            }
+            if (p >= size) {
+                // 序列不完整，丢弃到行尾
+                i = text_begin = size;
+                break;
+            }
+            const char final_byte = base[p++];
+            if (final_byte == 'm' && sgr_params) {
+                if (count < kMaxParams) params[count++] = static_cast<uint16_t>(value);
+                style.Apply(params, count, subparams);
+                color = style.Color();
+            }
+        } else if (kind == ']') {
+            // OSC：以BEL或ESC \结束
+            while (p < size && base[p] != '\007' && !(base[p] == '\033' && p + 1 < size && base[p + 1] == '\\')) ++p;
+            if (p < size) p += base[p] == '\007' ? 1 : 2;
+        }
+        // 其他两字节ESC序列：跳过ESC和后面的一个字节
+
+        i = text_begin = p;
+    }
+    flush(size);
+}
+
+#endif // ANSI_PARSER_H
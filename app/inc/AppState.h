@@ -5,23 +5,27 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <cstdint>
 
-#include "imgui.h"
 
+// 日志级别颜色(RGBA，分量0-1)，不依赖界面库，由界面层转换为ImVec4
+struct LogColor {
+    float x, y, z, w;
+};
 
 struct LogColors {
-    ImVec4 error_color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
-    ImVec4 warn_color = ImVec4(1.0f, 1.0f, 0.4f, 1.0f);
-    ImVec4 info_color = ImVec4(0.4f, 1.0f, 0.4f, 1.0f);
-    ImVec4 debug_color = ImVec4(0.6f, 0.6f, 1.0f, 1.0f);
-    ImVec4 trace_color = ImVec4(0.8f, 0.8f, 0.8f, 1.0f);
+    LogColor error_color = LogColor{1.0f, 0.4f, 0.4f, 1.0f};
+    LogColor warn_color = LogColor{1.0f, 1.0f, 0.4f, 1.0f};
+    LogColor info_color = LogColor{0.4f, 1.0f, 0.4f, 1.0f};
+    LogColor debug_color = LogColor{0.6f, 0.6f, 1.0f, 1.0f};
+    LogColor trace_color = LogColor{0.8f, 0.8f, 0.8f, 1.0f};
 
     void ResetToDefaults() {
-        error_color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
-        warn_color = ImVec4(1.0f, 1.0f, 0.4f, 1.0f);
-        info_color = ImVec4(0.4f, 1.0f, 0.4f, 1.0f);
-        debug_color = ImVec4(0.6f, 0.6f, 1.0f, 1.0f);
-        trace_color = ImVec4(0.8f, 0.8f, 0.8f, 1.0f);
+        error_color = LogColor{1.0f, 0.4f, 0.4f, 1.0f};
+        warn_color = LogColor{1.0f, 1.0f, 0.4f, 1.0f};
+        info_color = LogColor{0.4f, 1.0f, 0.4f, 1.0f};
+        debug_color = LogColor{0.6f, 0.6f, 1.0f, 1.0f};
+        trace_color = LogColor{0.8f, 0.8f, 0.8f, 1.0f};
     }
 };
 
@@ -34,6 +38,7 @@ public:
     void LoadSettings();
     void SaveSettings();
     void ApplySettings();
+    void ApplyLogFileSettings();
 
     // 启动命令历史记录管理
     void AddCommandToHistory(const std::string& command);
@@ -50,7 +55,18 @@ public:
     bool auto_working_dir;
     bool auto_scroll_logs;
     bool enable_colored_logs;
-    int max_log_lines;
+    int max_log_lines;          // 可选行数上限，0为不限
+    uint64_t max_log_bytes;     // 日志内存预算(字节)
+    bool enable_search_index;   // 为日志维护三元组搜索索引
+    bool enable_cold_log_tier;  // 超出内存预算的日志转存磁盘映射文件
+    uint64_t max_cold_log_bytes; // 冷层磁盘上限(字节)
+
+    // 日志文件相关配置
+    bool enable_log_file;
+    char log_file_directory[256]{};
+    int log_file_max_mb;        // 按大小轮转
+    int log_file_max_age_min;   // 按时间轮转，0为不按时间
+    bool compress_log_files;    // 轮转后压缩旧文件
     char web_url[256]{};
 
     // 停止命令相关配置
@@ -72,6 +88,10 @@ public:
     LogColors log_colors;
     bool use_custom_log_colors = false;
     bool use_ansi_colors = true;
+
+    // 界面重绘相关配置
+    int max_fps;                // 重绘帧率上限
+    bool power_save_unfocused;  // 窗口失去焦点时降低重绘帧率
     bool settings_dirty;
 
 
@@ -0,0 +1,22 @@
+#ifndef BLOCK_COMPRESSOR_H
+#define BLOCK_COMPRESSOR_H
+
+#include <cstddef>
+#include <filesystem>
+
+// 轻量块压缩(LZ77，类LZ4格式)：只用于已关闭的日志文件，追求速度而非压缩率
+// 序列格式: token(高4位字面量长度/低4位匹配长度-4) [长度扩展] 字面量 [偏移u16 [长度扩展]]
+// 块以只含字面量的序列结尾
+
+// 最坏情况下的压缩输出大小
+size_t BlockCompressBound(size_t size);
+// 返回压缩后的字节数，dst容量不足时返回0
+size_t BlockCompress(const char* src, size_t size, char* dst, size_t capacity);
+// 返回解压出的字节数，数据损坏或容量不足时返回0
+size_t BlockDecompress(const char* src, size_t size, char* dst, size_t capacity);
+
+// 文件格式: "LZB1" + 若干块[原始长度u32][存储长度u32(最高位为1表示未压缩)][数据] + 原始长度为0的结束块
+bool CompressFile(const std::filesystem::path& input, const std::filesystem::path& output);
+bool DecompressFile(const std::filesystem::path& input, const std::filesystem::path& output);
+
+#endif // BLOCK_COMPRESSOR_H
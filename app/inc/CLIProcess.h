@@ -2,10 +2,20 @@
 #define CLIPROCESS_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <mutex>
 #include <thread>
 #include <map>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "EncodingDetector.h"
+#include "LogFileSink.h"
+#include "LogStore.h"
+#include "OutputEncoding.h"
+#include "SpscQueue.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -15,32 +25,20 @@
 #include <signal.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <iconv.h>
 #endif
 
-// 输出编码枚举
-enum class OutputEncoding {
-    AUTO_DETECT = 0,
-    UTF8,
-#ifdef _WIN32
-    GBK,
-    GB2312,
-    BIG5,
-    SHIFT_JIS,
-#else
-    // Unix/Linux 常见编码
-    ISO_8859_1,
-    GB18030,
-    BIG5,
-    EUC_JP,
-#endif
-};
-
 class CLIProcess {
 public:
     CLIProcess();
     ~CLIProcess();
 
-    void SetMaxLogLines(int max_lines);
+    void SetMaxLogLines(int max_lines);      // 可选行数上限，0为不限
+    void SetMaxLogBytes(uint64_t max_bytes); // 日志内存预算(字节)
+    void SetColdLogTier(bool enable, uint64_t max_disk_bytes); // 超出内存预算的日志转存到临时目录下的映射文件
+    void SetLogFile(bool enable, const LogFileSinkConfig& config); // 子进程输出另存为可轮转的日志文件
+    bool IsLogFileEnabled() const { return file_sink_.IsRunning(); }
+    LogFileSink::Stats GetLogFileStats() const { return file_sink_.GetStats(); }
     void SetStopCommand(const std::string& command, int timeout_ms = 5000);
     void SetEnvironmentVariables(const std::map<std::string, std::string>& env_vars);
     void SetOutputEncoding(OutputEncoding encoding);
@@ -58,7 +56,26 @@ public:
 
     void ClearLogs();
     void AddLog(const std::string& log);
-    const std::vector<std::string>& GetLogs() const;
+    LogSnapshotPtr GetLogSnapshot() const;
+
+    // 日志全文搜索(不区分大小写)，返回匹配的行号
+    void SetSearchIndexEnabled(bool enable);
+    // 只查找行号不小于from_id的行；searched_end返回本次查到的位置，下次从这里继续即为增量搜索
+    std::vector<uint64_t> SearchLogs(const std::string& query, size_t max_results, uint64_t from_id,
+                                     uint64_t& searched_end) const;
+    size_t GetSearchIndexBytes() const;
+
+    // 读取线程产生的日志先进入无锁队列，由UI线程每帧批量取出
+    struct IngestStats {
+        size_t queue_depth;       // 当前队列深度(近似)
+        size_t queue_capacity;    // 队列容量
+        uint64_t dropped_lines;   // 队列满时丢弃的行数(累计)
+    };
+    size_t DrainIngestQueue();
+    IngestStats GetIngestStats() const;
+    // 有新日志进入队列时由读取线程调用，用于唤醒阻塞等待事件的界面循环；
+    // 每次DrainIngestQueue之后最多调用一次。须在启动子进程之前设置
+    void SetIngestWakeCallback(std::function<void()> callback) { ingest_wake_ = std::move(callback); }
 
     bool SendCommand(const std::string& command);
     void CopyLogsToClipboard() const;
@@ -73,6 +90,7 @@ public:
 
     // 编码相关接口
     OutputEncoding GetOutputEncoding() const;
+    EncodingDetector::Result GetDetectedEncoding() const;
     static std::string GetEncodingName(OutputEncoding encoding);
     static std::vector<std::pair<OutputEncoding, std::string>> GetSupportedEncodings();
 
@@ -83,16 +101,17 @@ public:
 
 private:
     void ReadOutput();
+    void PushOutputLine(std::string&& line);
+    std::unique_lock<std::mutex> LockLogs() const; // 加logs_mutex_并统计等待时间
     void CloseProcessHandles();
     void CleanupResources();
 
-    // 编码转换相关方法
-    static std::string ConvertToUTF8(std::string& input, OutputEncoding encoding);
-    std::string DetectAndConvertToUTF8(std::string& input);
-
 #ifdef _WIN32
+    // 编码转换相关方法
+    // 结果写入调用方复用的缓冲区，返回值在缓冲区下次使用前有效；转换失败时返回原始输入
+    static std::string_view ConvertToUTF8(std::string_view input, OutputEncoding encoding,
+                                          std::wstring& wide_buffer, std::string& buffer);
     static UINT GetCodePageFromEncoding(OutputEncoding encoding);
-    static bool IsValidUTF8(const std::string& str);
 
     PROCESS_INFORMATION pi_{};
     HANDLE hReadPipe_{};
@@ -104,16 +123,35 @@ private:
     pid_t process_pid_;
     int pipe_stdout_[2];
     int pipe_stdin_[2];
-    bool process_running_;
+    int stop_pipe_[2];                           // 自管道：Stop()写入一个字节唤醒读取线程
+    mutable std::atomic<bool> process_running_;  // IsRunning()回收已退出的子进程时清除
+    static constexpr int kTermGraceMs = 2000;    // SIGTERM后等待进程组退出的时间，超时改用SIGKILL
 
-    // Unix 编码转换辅助函数
-    std::string ConvertUnixEncoding(const std::string& input, const std::string& from_encoding);
+    void TerminateProcessGroup();
+
+    // Unix 编码转换辅助函数(只由读取线程使用)
+    std::string_view ConvertUnixEncoding(std::string_view input, const std::string& from_encoding);
+    void ResetUnixEncodingState();
     static std::string GetUnixEncodingName(OutputEncoding encoding);
+    std::map<std::string, iconv_t> iconv_descriptors_;  // 编码名 -> 转换描述符，打开失败为(iconv_t)-1
+    std::string iconv_output_;                          // 复用的转换输出缓冲区
 #endif
 
     mutable std::mutex logs_mutex_;
-    std::vector<std::string> logs_;
+    LogStore logs_;
     int max_log_lines_;
+    uint64_t max_log_bytes_;
+
+    // 读取线程(生产者) -> UI线程(消费者)
+    static constexpr size_t kIngestQueueCapacity = 65536;
+    SpscQueue<std::string> ingest_queue_;
+    std::atomic<uint64_t> ingest_dropped_{0};
+    uint64_t ingest_dropped_reported_ = 0;
+    std::function<void()> ingest_wake_;
+    std::atomic<bool> ingest_wake_pending_{false};
+
+    // 与界面队列相互独立，界面队列满时文件中仍是完整输出
+    LogFileSink file_sink_;
 
     std::thread output_thread_;
 
@@ -129,6 +167,7 @@ private:
     // 编码相关
     mutable std::mutex encoding_mutex_;
     OutputEncoding output_encoding_;
+    EncodingDetector::Result detected_encoding_{OutputEncoding::UTF8, 0.0f, false};
 
     // 工作目录相关
     mutable std::mutex working_dir_mutex_;
@@ -0,0 +1,62 @@
+#ifndef ENCODING_DETECTOR_H
+#define ENCODING_DETECTOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "OutputEncoding.h"
+
+// 自动检测模式的编码识别
+// 一次扫描同时按各候选编码的字节结构切分多字节字符：不合语法的字节对计为错误，
+// 落在该编码高频区(常用汉字、假名、全角标点)的字符计满分，其余合法字符计低分，得分比例即置信度。
+// 证据足够且领先明显时锁定该编码，之后只校验新数据在该编码下是否合法，出现解码错误才重新评估
+class EncodingDetector {
+public:
+    struct Result {
+        OutputEncoding encoding;
+        float confidence;   // 0~1，尚无多字节证据时为0
+        bool locked;
+    };
+
+    // 返回本块应使用的编码(不会是AUTO_DETECT)
+    OutputEncoding Resolve(std::string_view data);
+    Result Current() const { return {current_, confidence_, locked_}; }
+    void Reset();
+
+private:
+    static constexpr size_t kMinLockChars = 64;     // 锁定前至少需要的多字节字符数
+    static constexpr float kMinLockConfidence = 0.8f;
+    static constexpr float kMinLockMargin = 0.05f;
+
+    struct Score {
+        uint32_t chars = 0;     // 合法多字节字符
+        uint32_t common = 0;    // 其中落在高频区的字符
+        uint32_t errors = 0;
+        float Confidence() const;
+    };
+
+#ifdef _WIN32
+    static constexpr std::array<OutputEncoding, 4> kCandidates = {
+        OutputEncoding::UTF8, OutputEncoding::GBK, OutputEncoding::BIG5, OutputEncoding::SHIFT_JIS};
+#else
+    static constexpr std::array<OutputEncoding, 4> kCandidates = {
+        OutputEncoding::UTF8, OutputEncoding::GB18030, OutputEncoding::BIG5, OutputEncoding::EUC_JP};
+#endif
+
+    static void Accumulate(std::string_view data, std::array<Score, kCandidates.size()>& scores);
+    static uint32_t CountErrors(std::string_view data, OutputEncoding encoding);
+    void Evaluate();
+
+    std::array<Score, kCandidates.size()> scores_{};
+#ifdef _WIN32
+    OutputEncoding current_ = OutputEncoding::GBK;
+#else
+    OutputEncoding current_ = OutputEncoding::GB18030;
+#endif
+    float confidence_ = 0.0f;
+    bool locked_ = false;
+};
+
+#endif // ENCODING_DETECTOR_H
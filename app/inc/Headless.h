@@ -0,0 +1,11 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// 无界面托管模式(--headless)：不初始化GLFW/OpenGL/ImGui/字体/托盘，
+// 直接用AppState加载climanager_settings.ini，启动并看护子进程，输出只写入日志文件。
+// 子进程退出后按退避间隔自动重启；收到Ctrl+C/SIGTERM等时执行停止流程后返回。
+// 入口有两个：界面程序的--headless参数，以及只链接climanager_core的climanager_headless(main_headless.cpp)
+bool IsHeadlessRequested(int argc, char** argv);
+int RunHeadless();
+
+#endif // HEADLESS_H
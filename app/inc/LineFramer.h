@@ -0,0 +1,99 @@
+#ifndef LINE_FRAMER_H
+#define LINE_FRAMER_H
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// 管道输出分行器
+// 每次read()得到的字节块可能是半行也可能是几十行：完整的行立即交出，末尾的半行留到下一块拼接。
+// 全程使用显式长度，内容中的NUL字节不会截断行；换行扫描使用memchr(C库中为向量化实现)
+// 单行超过kMaxLineBytes时在UTF-8字符边界处强制断开，只用\r刷新的进度条或二进制输出不会让缓冲无限增长
+class LineFramer {
+public:
+    static constexpr size_t kMaxLineBytes = 64 * 1024;
+
+    // on_line(std::string&&)对每个完整的非空行调用一次，行尾的\r被去掉
+    template<typename Fn>
+    void Feed(std::string_view chunk, Fn&& on_line) {
+        const char* p = chunk.data();
+        const char* const end = p + chunk.size();
+
+        while (p < end) {
+            const auto* newline = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!newline) {
+                partial_.append(p, static_cast<size_t>(end - p));
+                SpillOverlong(on_line);
+                return;
+            }
+
+            if (partial_.empty()) {
+                Emit(std::string(p, static_cast<size_t>(newline - p)), on_line);
+            } else {
+                partial_.append(p, static_cast<size_t>(newline - p));
+                Emit(std::move(partial_), on_line);
+                partial_.clear();
+            }
+            p = newline + 1;
+        }
+    }
+
+    // 输出结束时交出最后一段没有换行符的内容
+    template<typename Fn>
+    void Flush(Fn&& on_line) {
+        if (!partial_.empty()) {
+            Emit(std::move(partial_), on_line);
+            partial_.clear();
+        }
+    }
+
+    void Reset() { partial_.clear(); }
+
+private:
+    // 不超过limit的最后一个UTF-8字符边界(要求text.size() > limit)；找不到合法边界时按limit截断
+    static size_t CutPoint(std::string_view text, size_t limit) {
+        size_t cut = limit;
+        while (cut > 0 && limit - cut < 3 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+            --cut;
+        }
+        return (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80 || cut == 0 ? limit : cut;
+    }
+
+    // 超长的部分按kMaxLineBytes切出交出，剩余部分留在partial_中等待换行
+    template<typename Fn>
+    void SpillOverlong(Fn& on_line) {
+        if (partial_.size() <= kMaxLineBytes) return;
+        std::string_view rest = partial_;
+        while (rest.size() > kMaxLineBytes) {
+            const size_t cut = CutPoint(rest, kMaxLineBytes);
+            on_line(std::string(rest.substr(0, cut)));
+            rest.remove_prefix(cut);
+        }
+        partial_.erase(0, partial_.size() - rest.size());
+    }
+
+    template<typename Fn>
+    static void Emit(std::string&& line, Fn& on_line) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.size() > kMaxLineBytes) {
+            std::string_view rest = line;
+            while (rest.size() > kMaxLineBytes) {
+                const size_t cut = CutPoint(rest, kMaxLineBytes);
+                on_line(std::string(rest.substr(0, cut)));
+                rest.remove_prefix(cut);
+            }
+            if (!rest.empty()) on_line(std::string(rest));
+            return;
+        }
+        if (!line.empty()) {
+            on_line(std::move(line));
+        }
+    }
+
+    std::string partial_;
+};
+
+#endif // LINE_FRAMER_H
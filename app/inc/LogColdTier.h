@@ -0,0 +1,156 @@
+#ifndef LOG_COLD_TIER_H
+#define LOG_COLD_TIER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "LogLine.h"
+#include "MappedFile.h"
+
+struct LogChunk;
+
+// 冷层段文件：只追加写一次，之后以只读内存映射方式访问
+// 布局: [行记录][offsets: uint64 x (n+1)][flags: uint32 x n][LogColdSegmentFooter]
+// 行记录与内存块中相同：文本后紧跟颜色段表，段数记在flags中
+struct LogColdSegmentFooter {
+    static constexpr uint32_t kMagic = 0x474C4353; // "SCLG"
+    static constexpr uint32_t kVersion = 2;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t first_id;
+    uint64_t line_count;
+    uint64_t data_bytes;
+};
+
+class LogColdSegment {
+public:
+    ~LogColdSegment();
+
+    // 将若干连续的块写成段文件并映射，失败返回nullptr
+    static std::shared_ptr<LogColdSegment> Write(const std::filesystem::path& path,
+                                                 const std::vector<std::shared_ptr<const LogChunk>>& chunks);
+
+    uint64_t FirstId() const { return first_id_; }
+    uint64_t EndId() const { return first_id_ + line_count_; }
+    size_t FileBytes() const { return file_.Size(); }
+
+    std::string_view Line(size_t index) const { return View(index).text; }
+
+    LogLineView View(size_t index) const {
+        touched_.store(true, std::memory_order_relaxed);
+        const uint64_t begin = offsets_[index];
+        const size_t length = static_cast<size_t>(offsets_[index + 1] - begin) - LogRunBytes(flags_[index]);
+        return {{data_ + begin, length}, data_ + begin + length, flags_[index]};
+    }
+
+    uint32_t Flags(size_t index) const { return flags_[index]; }
+
+    // 自上次检查以来未被访问过的段释放常驻页(每次空闲只释放一次)
+    void TrimIfIdle() const;
+
+private:
+    LogColdSegment() = default;
+    bool Map(const std::filesystem::path& path);
+
+    std::filesystem::path path_;
+    MappedFile file_;
+    const char* data_ = nullptr;
+    const uint64_t* offsets_ = nullptr;
+    const uint32_t* flags_ = nullptr;
+    uint64_t first_id_ = 0;
+    uint64_t line_count_ = 0;
+
+    mutable std::atomic<bool> touched_{false};
+    mutable bool released_ = true;
+};
+
+using LogColdSegmentPtr = std::shared_ptr<const LogColdSegment>;
+
+// 日志冷层
+// 热层整块淘汰下来的日志先暂存在待写列表中(仍是内存块，可直接读取)，攒够一个段后交给后台线程写入段文件，
+// 写完并映射后由Collect()换下对应的内存块；写盘期间这些块照常可读，调用方不等待磁盘。
+// 段文件只属于当前会话：目录按进程区分，段对象释放时删除文件，磁盘占用超过上限时丢弃最旧的段。
+class LogColdTier {
+public:
+    static constexpr size_t kSegmentBytes = 16 * 1024 * 1024;
+    // 同时在写的段数上限；达到上限后新淘汰的块留在内存中继续攒段，等写线程空出后再提交
+    static constexpr size_t kMaxSealingSegments = 4;
+    // 攒段的块超过该字节数说明磁盘长期跟不上：丢弃已交给写线程的最旧部分，而不是在日志锁内等待磁盘
+    static constexpr size_t kMaxBacklogBytes = kMaxSealingSegments * kSegmentBytes;
+
+    LogColdTier(const std::filesystem::path& root_dir, uint64_t max_disk_bytes);
+    ~LogColdTier();
+
+    // 系统临时目录下的climanager_log_cache，与启动时的当前目录和子进程工作目录无关
+    static std::filesystem::path DefaultRootDir();
+
+    LogColdTier(const LogColdTier&) = delete;
+    LogColdTier& operator=(const LogColdTier&) = delete;
+
+    void SetMaxDiskBytes(uint64_t max_disk_bytes);
+    void Append(std::shared_ptr<const LogChunk> chunk);
+    void Clear();
+    // 收取后台写完的段，有变化时返回true
+    bool Collect();
+    void TrimResident() const;
+
+    bool Empty() const { return segments_.empty() && pending_.empty(); }
+    uint64_t BeginId() const;
+    uint64_t DiskBytes() const { return disk_bytes_; }
+
+    const std::vector<LogColdSegmentPtr>& Segments() const { return segments_; }
+    const std::vector<std::shared_ptr<const LogChunk>>& Pending() const { return pending_; }
+
+private:
+    struct SealJob {
+        uint64_t epoch;
+        std::filesystem::path path;
+        std::vector<std::shared_ptr<const LogChunk>> chunks;
+    };
+    struct SealResult {
+        uint64_t epoch;
+        size_t chunk_count;
+        std::shared_ptr<LogColdSegment> segment;    // 写入失败为nullptr
+    };
+
+    void SealIfReady();
+    void Seal();
+    void DropSealing();
+    void WriterLoop();
+    void EnforceDiskBudget();
+
+    std::filesystem::path dir_;
+    uint64_t max_disk_bytes_;
+    uint64_t disk_bytes_ = 0;
+
+    std::vector<LogColdSegmentPtr> segments_;
+    // 未落成段文件的块：前sealing_chunks_个已交给写线程，其余仍在攒段
+    std::vector<std::shared_ptr<const LogChunk>> pending_;
+    size_t pending_bytes_ = 0;
+    size_t sealing_chunks_ = 0;
+    size_t sealing_segments_ = 0;
+    uint64_t epoch_ = 0;                            // Clear()或DropSealing()后递增，丢弃旧的写入结果
+
+    // 调用方与写线程共享
+    std::mutex writer_mutex_;
+    std::condition_variable job_cv_;
+    std::deque<SealJob> jobs_;
+    std::vector<SealResult> results_;
+    std::atomic<bool> results_ready_{false};
+    bool writer_stop_ = false;
+    std::thread writer_thread_;
+
+    mutable std::chrono::steady_clock::time_point last_trim_{};
+};
+
+#endif // LOG_COLD_TIER_H
@@ -0,0 +1,94 @@
+#ifndef LOG_FILE_INDEX_H
+#define LOG_FILE_INDEX_H
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+// 日志文件旁的行偏移索引(<日志文件>.idx)
+// 每kSampleLines行记录一次该行的起始偏移和写入时间，打开任意大小的日志只需读入索引，
+// 定位某一行或某一时刻为二分查找 + 至多kSampleLines行的前向扫描
+// 布局: [LogIndexHeader][LogIndexEntry...]，只追加写，末尾不完整的记录在读取时忽略
+struct LogIndexHeader {
+    static constexpr uint32_t kMagic = 0x5844494C; // "LIDX"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sample_lines;
+    uint32_t reserved;
+};
+
+struct LogIndexEntry {
+    uint64_t line;      // 行号(从0开始)
+    uint64_t offset;    // 该行在日志文件中的起始字节偏移
+    int64_t time_ms;    // 写入时间(Unix毫秒)
+};
+
+std::filesystem::path LogIndexPathFor(const std::filesystem::path& log_path);
+
+// 写入端：由LogFileSink的写线程随日志内容一起调用
+class LogIndexWriter {
+public:
+    static constexpr uint32_t kSampleLines = 1024;
+
+    LogIndexWriter() = default;
+    ~LogIndexWriter();
+
+    LogIndexWriter(const LogIndexWriter&) = delete;
+    LogIndexWriter& operator=(const LogIndexWriter&) = delete;
+
+    bool Open(const std::filesystem::path& log_path);
+    void Close();
+    void Flush();
+
+    // data为即将写入日志文件offset处的内容，且总是以完整行结尾
+    void Observe(std::string_view data, uint64_t offset);
+
+private:
+    void WriteEntry(uint64_t line, uint64_t offset, int64_t time_ms);
+
+    FILE* file_ = nullptr;
+    uint64_t lines_ = 0;
+    uint64_t next_sample_ = 0;
+};
+
+// 读取端：映射日志文件并按索引随机访问行
+class LogFileReader {
+public:
+    bool Open(const std::filesystem::path& log_path);
+    // 重新映射仍在写入的文件，读取新增的内容和索引
+    bool Refresh();
+    void Close();
+
+    bool IsOpen() const { return file_.IsOpen(); }
+    const std::filesystem::path& Path() const { return path_; }
+    uint64_t LineCount() const { return line_count_; }
+    uint64_t FileBytes() const { return file_.Size(); }
+
+    std::string_view Line(uint64_t line) const;
+    // 最后一个写入时间早于time_ms的采样块的首行，该时刻及之后的输出都在它后面
+    uint64_t LineAtTime(int64_t time_ms) const;
+    // 所在采样块的写入时间，没有索引时返回0
+    int64_t TimeOfLine(uint64_t line) const;
+
+private:
+    bool LoadIndex();
+    void BuildIndex();
+    uint64_t OffsetOf(uint64_t line) const;
+
+    std::filesystem::path path_;
+    MappedFile file_;
+    std::vector<LogIndexEntry> entries_;
+    uint64_t line_count_ = 0;
+
+    // 顺序读取相邻行时从上一次的位置继续扫描
+    mutable uint64_t cursor_line_ = 0;
+    mutable uint64_t cursor_offset_ = 0;
+};
+
+#endif // LOG_FILE_INDEX_H
@@ -0,0 +1,94 @@
+#ifndef LOG_FILE_SINK_H
+#define LOG_FILE_SINK_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "LogFileIndex.h"
+
+struct LogFileSinkConfig {
+    std::filesystem::path directory = "logs";
+    uint64_t max_file_bytes = 64ull * 1024 * 1024;   // 单个文件达到该大小后轮转
+    std::chrono::seconds max_file_age{3600};          // 文件打开超过该时长后轮转，0为不按时间轮转
+    bool compress_closed = false;                     // 轮转后将旧文件压缩为.lzb
+    size_t max_files = 50;                            // 目录中最多保留的日志文件数，0为不限
+
+    bool operator==(const LogFileSinkConfig&) const = default;
+};
+
+// 持久化日志文件
+// Append只把行追加到内存缓冲区，写盘、轮转和压缩都在后台线程完成，调用方永远不会等待磁盘；
+// 缓冲区积压超过上限时丢弃新行并计数。每个日志文件旁同步写出行偏移索引(见LogFileIndex.h)
+class LogFileSink {
+public:
+    static constexpr size_t kMaxBufferBytes = 64 * 1024 * 1024;
+    static constexpr size_t kFlushBytes = 1024 * 1024;
+
+    struct Stats {
+        uint64_t written_bytes;     // 已写入文件的字节数(累计)
+        uint64_t dropped_bytes;     // 缓冲区满时丢弃的字节数(累计)
+        size_t buffered_bytes;      // 等待写盘的字节数
+    };
+
+    LogFileSink() = default;
+    ~LogFileSink();
+
+    LogFileSink(const LogFileSink&) = delete;
+    LogFileSink& operator=(const LogFileSink&) = delete;
+
+    // 以新配置(重新)启动，从一个新文件开始；已在运行且配置相同时什么也不做
+    void Start(const LogFileSinkConfig& config);
+    // 写完缓冲区中剩余的行后停止
+    void Stop();
+    bool IsRunning() const { return running_.load(std::memory_order_acquire); }
+
+    void Append(std::string_view line);
+    Stats GetStats() const;
+
+private:
+    void WriterLoop();
+    void CompressLoop();
+    void WriteBatch(std::string_view data);
+    void OpenNewFile();
+    void CloseCurrentFile();
+    void EnforceFileCount();
+
+    LogFileSinkConfig config_;
+    std::atomic<bool> running_{false};
+
+    // 生产者与写线程共享
+    mutable std::mutex buffer_mutex_;
+    std::condition_variable buffer_cv_;
+    std::string buffer_;
+    bool stop_requested_ = false;
+    std::atomic<uint64_t> written_bytes_{0};
+    std::atomic<uint64_t> dropped_bytes_{0};
+
+    // 仅写线程访问
+    FILE* file_ = nullptr;
+    LogIndexWriter index_;
+    std::filesystem::path current_path_;
+    uint64_t file_bytes_ = 0;
+    std::chrono::steady_clock::time_point file_opened_;
+    uint32_t file_sequence_ = 0;
+
+    // 待压缩的已关闭文件
+    std::mutex compress_mutex_;
+    std::condition_variable compress_cv_;
+    std::deque<std::filesystem::path> compress_queue_;
+    bool compress_stop_ = false;
+
+    std::thread writer_thread_;
+    std::thread compress_thread_;
+};
+
+#endif // LOG_FILE_SINK_H
@@ -0,0 +1,65 @@
+#ifndef LOG_FILTER_VIEW_H
+#define LOG_FILTER_VIEW_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogStore.h"
+
+// 过滤视图：只显示包含指定文本(不区分大小写)的行
+// 维护匹配行号的升序列表，每帧只检查新到达的行并丢弃已淘汰的行；
+// 更换过滤条件时在后台线程扫描当时的快照，完成后再接着处理扫描期间到达的行
+class LogFilterView {
+public:
+    static constexpr uint64_t kMaxLinesPerFrame = 20000;
+
+    LogFilterView() = default;
+    ~LogFilterView();
+
+    LogFilterView(const LogFilterView&) = delete;
+    LogFilterView& operator=(const LogFilterView&) = delete;
+
+    // 后台扫描完成时由扫描线程调用，用于唤醒阻塞等待事件的界面循环，否则结果要等下一个事件才显示
+    void SetWakeCallback(std::function<void()> callback) { wake_ = std::move(callback); }
+    // 空串关闭过滤
+    void SetPattern(const std::string& pattern, const LogSnapshotPtr& logs);
+    // 由UI线程每帧调用一次
+    void Update(const LogSnapshot& logs);
+
+    bool Active() const { return !pattern_.empty(); }
+    const std::string& Pattern() const { return pattern_; }
+    bool Scanning() const { return job_ != nullptr; }
+    float Progress() const;
+
+    size_t Size() const { return ids_.size() - head_; }
+    uint64_t IdAt(size_t row) const { return ids_[head_ + row]; }
+    // 行号在视图中的行位置，不在视图中返回SIZE_MAX
+    size_t RowOf(uint64_t id) const;
+
+private:
+    struct Job {
+        std::thread thread;
+        std::atomic<bool> cancel{false};
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> scanned{0};
+        uint64_t begin_id = 0;
+        uint64_t end_id = 0;
+        std::vector<uint64_t> ids;
+    };
+
+    void CancelJob();
+
+    std::function<void()> wake_;
+    std::string pattern_;
+    std::unique_ptr<Job> job_;
+    std::vector<uint64_t> ids_;
+    size_t head_ = 0;               // ids_中已淘汰的前缀长度
+    uint64_t scanned_end_ = 0;      // 该行号之前的行都已检查过
+};
+
+#endif // LOG_FILTER_VIEW_H
@@ -0,0 +1,21 @@
+#ifndef LOG_LEVEL_H
+#define LOG_LEVEL_H
+
+#include <cstdint>
+#include <string_view>
+
+// 日志级别：入库时识别一次，按一个字节存放在行标志中(见LogLine.h)
+// 数值越小优先级越高，一行同时含有多个级别的关键字时取优先级最高的
+enum class LogLevel : uint8_t {
+    None = 0,
+    Error,
+    Warn,
+    Info,
+    Debug,
+    Trace
+};
+
+// 对所有级别关键字构建的Aho-Corasick自动机做一遍扫描，每字节一次查表
+LogLevel ClassifyLogLevel(std::string_view text);
+
+#endif // LOG_LEVEL_H
@@ -0,0 +1,52 @@
+#ifndef LOG_LINE_H
+#define LOG_LINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "LogLevel.h"
+
+// 颜色段：从文本的offset处开始(直到下一段或行尾)使用color(IM_COL32布局，见AnsiParser.h)
+struct LogColorRun {
+    uint32_t offset;
+    uint32_t color;
+};
+
+// 行标志的低16位为颜色段数，颜色段表紧跟在行文本之后存放(不保证对齐)；16-23位为日志级别
+constexpr uint32_t kLogRunCountMask = 0xFFFF;
+constexpr size_t kLogMaxRuns = kLogRunCountMask;
+constexpr unsigned kLogLevelShift = 16;
+
+constexpr uint32_t MakeLogLineFlags(size_t run_count, LogLevel level) {
+    return static_cast<uint32_t>(run_count) | (static_cast<uint32_t>(level) << kLogLevelShift);
+}
+
+inline size_t LogRunBytes(uint32_t flags) {
+    return static_cast<size_t>(flags & kLogRunCountMask) * sizeof(LogColorRun);
+}
+
+// 存储中一行的只读视图：入库时已去掉ANSI转义序列的文本，以及预先解析好的颜色段和日志级别
+// 没有颜色段的行整体使用默认颜色
+struct LogLineView {
+    std::string_view text;
+    const char* runs = nullptr;
+    uint32_t flags = 0;
+
+    size_t RunCount() const { return flags & kLogRunCountMask; }
+    LogLevel Level() const { return static_cast<LogLevel>((flags >> kLogLevelShift) & 0xFF); }
+
+    LogColorRun Run(size_t index) const {
+        LogColorRun run;
+        memcpy(&run, runs + index * sizeof(LogColorRun), sizeof(run));
+        return run;
+    }
+
+    // 第index段的结束位置
+    size_t RunEnd(size_t index) const {
+        return index + 1 < RunCount() ? Run(index + 1).offset : text.size();
+    }
+};
+
+#endif // LOG_LINE_H
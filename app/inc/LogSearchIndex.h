@@ -0,0 +1,45 @@
+#ifndef LOG_SEARCH_INDEX_H
+#define LOG_SEARCH_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// 日志三元组倒排索引(ASCII不区分大小写)
+// 以64行为一个块记录"哪些块出现过该三元组"，查询时对各三元组的块列表求交得到候选块，再逐行确认。
+// 三元组散列到固定数量的桶中：冲突只会多出候选块，不会漏掉匹配。
+// 淘汰不逐行回删：起始块前进足够多后整体清扫一次，查询时跳过已淘汰的块
+class LogSearchIndex {
+public:
+    static constexpr uint32_t kBlockShift = 6;
+    static constexpr uint64_t kBlockLines = uint64_t(1) << kBlockShift;
+    static constexpr size_t kMinQueryBytes = 3;     // 短于此的查询无法使用索引，只能逐行扫描
+
+    LogSearchIndex();
+
+    void Add(uint64_t id, std::string_view line);
+    void PruneBefore(uint64_t begin_id);
+    void Clear();
+
+    // 查询不足3字节时无法使用索引，返回false
+    bool CandidateBlocks(std::string_view query, uint64_t begin_id, std::vector<uint64_t>& blocks) const;
+    size_t MemoryBytes() const;
+
+    // ASCII不区分大小写的子串查找，未找到返回npos
+    static size_t FindIgnoreCase(std::string_view text, std::string_view pattern, size_t from = 0);
+
+private:
+    static constexpr uint32_t kBucketBits = 18;
+    static constexpr size_t kBuckets = size_t(1) << kBucketBits;
+    static constexpr uint64_t kPruneBlocks = 1024;
+
+    static uint32_t Bucket(unsigned char a, unsigned char b, unsigned char c);
+
+    std::vector<std::vector<uint32_t>> postings_;   // 桶 -> 升序块号
+    std::unique_ptr<uint64_t[]> seen_;              // 当前块中已登记的桶(位图)
+    uint64_t current_block_ = UINT64_MAX;
+    uint64_t pruned_block_ = 0;
+};
+
+#endif // LOG_SEARCH_INDEX_H
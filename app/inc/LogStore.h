@@ -0,0 +1,163 @@
+#ifndef LOG_STORE_H
+#define LOG_STORE_H
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogColdTier.h"
+#include "LogLine.h"
+#include "LogSearchIndex.h"
+
+// 每行的紧凑元数据，行内容存放在所属块的字节区中
+struct LogLineMeta {
+    uint32_t offset;    // 在块字节区中的偏移
+    uint32_t length;    // 文本字节长度(不含其后的颜色段表)
+    uint32_t flags;     // 见LogLine.h
+};
+
+// 日志块：行字节连续存放在一次性分配的字节区中，元数据数组同样预先分配
+// 写入只追加到已发布范围之后，已写入的行不再移动；块被淘汰时只摘除引用，仍被快照持有的块不会释放
+struct LogChunk {
+    static constexpr size_t kLines = 4096;
+    static constexpr size_t kBytes = 256 * 1024;
+
+    LogChunk(uint64_t first, size_t byte_capacity)
+        : first_id(first),
+          bytes(new char[byte_capacity]),
+          byte_capacity(byte_capacity),
+          lines(new LogLineMeta[kLines]) {}
+
+    bool CanFit(size_t length) const {
+        return line_count < kLines && byte_used + length <= byte_capacity;
+    }
+
+    std::string_view Line(size_t index) const {
+        const LogLineMeta& meta = lines[index];
+        return {bytes.get() + meta.offset, meta.length};
+    }
+
+    LogLineView View(size_t index) const {
+        const LogLineMeta& meta = lines[index];
+        const char* text = bytes.get() + meta.offset;
+        return {{text, meta.length}, text + meta.length, meta.flags};
+    }
+
+    // 块实际分配的内存：字节区容量加预分配的元数据数组，不论已用多少
+    size_t AllocatedBytes() const {
+        return byte_capacity + kLines * sizeof(LogLineMeta);
+    }
+
+    // 该行占用的字节区大小(文本+颜色段表)
+    size_t RecordBytes(size_t index) const {
+        return lines[index].length + LogRunBytes(lines[index].flags);
+    }
+
+    uint64_t first_id;                      // 块内第一行的全局行号
+    std::unique_ptr<char[]> bytes;
+    size_t byte_capacity;
+    size_t byte_used = 0;
+    std::unique_ptr<LogLineMeta[]> lines;
+    size_t line_count = 0;
+};
+
+// 日志只读快照
+// 持有所覆盖块(以及冷层段)的引用，读取期间写线程的追加和淘汰都不会使其中的行失效；不复制行内容
+// 启用冷层时行号范围从冷层最旧的行开始，按行号透明地落到段文件或内存块上
+class LogSnapshot {
+public:
+    uint64_t Generation() const { return generation_; }
+    uint64_t BeginId() const { return begin_id_; }
+    uint64_t EndId() const { return end_id_; }
+    size_t Size() const { return static_cast<size_t>(end_id_ - begin_id_); }
+    bool Empty() const { return end_id_ == begin_id_; }
+
+    // 快照时刻内存块分配的字节数(含块内未用的容量)
+    size_t RetainedBytes() const { return retained_bytes_; }
+    uint64_t ColdDiskBytes() const { return cold_disk_bytes_; }
+
+    // 0为快照内最旧的行
+    std::string_view operator[](size_t index) const { return ById(begin_id_ + index); }
+    std::string_view ById(uint64_t id) const { return ViewById(id).text; }
+    LogLineView ViewById(uint64_t id) const;
+
+private:
+    friend class LogStore;
+
+    std::vector<LogColdSegmentPtr> segments_;
+    std::vector<std::shared_ptr<const LogChunk>> chunks_;
+    uint64_t generation_ = 0;
+    uint64_t begin_id_ = 0;
+    uint64_t end_id_ = 0;
+    size_t retained_bytes_ = 0;
+    uint64_t cold_disk_bytes_ = 0;
+};
+
+using LogSnapshotPtr = std::shared_ptr<const LogSnapshot>;
+
+// 按块组织的环形日志存储，淘汰为O(1)
+// 保留量以字节预算为准，按块实际分配的内存计入(块内未用的容量和预分配的元数据一并计入)，超出时整块淘汰；
+// 可选再叠加行数上限，按行淘汰；最新的一行总是保留
+// 非线程安全，由CLIProcess在logs_mutex_下访问；读者通过Snapshot()获得可脱离锁使用的视图
+class LogStore {
+public:
+    static constexpr size_t kLineOverhead = sizeof(LogLineMeta);
+    // 每隔多少行计时一次(见PerfCounters)，按比例折算
+    static constexpr uint32_t kPerfSampleInterval = 8;
+
+    explicit LogStore(size_t max_bytes = 64 * 1024 * 1024, size_t max_lines = 0);
+
+    // max_lines为0表示不限制行数
+    void SetLimits(size_t max_bytes, size_t max_lines);
+    // 入库时解析一次ANSI转义序列并识别日志级别：只保存去掉转义序列的文本、颜色段表和级别，显示时不再解析
+    void Push(std::string_view line);
+    void Clear();
+
+    // 冷层：淘汰出内存预算的整块写入段文件，仍可通过快照浏览
+    void EnableColdTier(const std::filesystem::path& dir, uint64_t max_disk_bytes);
+    // 摘下冷层交给调用方：销毁时要等写线程写完当前段，调用方应在释放日志锁之后再销毁
+    [[nodiscard]] std::unique_ptr<LogColdTier> DisableColdTier();
+    // 换入后台写完的段并释放空闲段的常驻页，由写入方定期调用
+    void MaintainColdTier();
+
+    // 全文搜索：只覆盖内存中保留的行，返回升序行号(超过max_results时保留最新的)
+    // from_id用于增量搜索：只查找行号不小于它的行，传入上次搜索时的EndId()即可只查新到达的行
+    void SetSearchIndexEnabled(bool enable);
+    std::vector<uint64_t> Search(std::string_view query, size_t max_results, uint64_t from_id = 0) const;
+    size_t SearchIndexBytes() const { return search_index_ ? search_index_->MemoryBytes() : 0; }
+
+    size_t Size() const { return static_cast<size_t>(end_id_ - begin_id_); }
+    bool Empty() const { return end_id_ == begin_id_; }
+    uint64_t EndId() const { return end_id_; }
+    size_t MaxBytes() const { return max_bytes_; }
+    size_t MaxLines() const { return max_lines_; }
+    size_t RetainedBytes() const { return retained_bytes_; }
+    uint64_t Generation() const { return generation_; }
+
+    // 同一代内重复调用返回同一个快照，每帧多次调用只需一次引用计数
+    LogSnapshotPtr Snapshot() const;
+
+private:
+    void PopFrontChunk();
+    void Evict();
+    std::string_view LineById(uint64_t id) const;
+
+    std::deque<std::shared_ptr<LogChunk>> chunks_;
+    std::unique_ptr<LogColdTier> cold_tier_;
+    std::unique_ptr<LogSearchIndex> search_index_;
+    size_t max_bytes_;
+    size_t max_lines_;
+    size_t retained_bytes_ = 0;
+    uint64_t begin_id_ = 0;
+    uint64_t end_id_ = 0;
+    uint64_t generation_ = 0;
+    uint32_t perf_sample_counter_ = 0;
+
+    mutable LogSnapshotPtr cached_snapshot_;
+};
+
+#endif // LOG_STORE_H
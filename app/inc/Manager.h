@@ -1,7 +1,11 @@
 #pragma once
 
 // 系统头文件
+#include <array>
+#include <chrono>
+#include <filesystem>
 #include <memory>
+#include <vector>
 
 // 第三方库头文件
 #include "imgui.h"
@@ -35,7 +39,11 @@
 
 // 项目头文件
 #include "AppState.h"
+#include "LogFileIndex.h"
+#include "LogFilterView.h"
+#include "PerfCounters.h"
 #include "TrayIcon.h"
+#include "Units.h"
 
 
 class Manager {
@@ -81,8 +89,14 @@ private:
     void RenderControlPanel(float buttonWidth, float buttonHeight, float inputWidth); // 渲染控制面板
     void RenderCommandPanel(float buttonWidth, float inputWidth); // 渲染命令面板
     void RenderLogPanel(); // 渲染日志面板
+    void UpdateLogSearch(const LogSnapshot& logs, bool changed, bool confirmed); // 按需执行或增量更新日志搜索
+    void DrawSearchHighlights(std::string_view log, bool current); // 在当前行下方绘制匹配高亮
     void RenderCommandHistory(); // 渲染命令历史
+    void RenderLogFileViewer(); // 渲染历史日志浏览窗口
+    void RefreshLogFileList(); // 重新列出日志目录中的文件
     void RenderStatusMessages(); // 渲染状态消息
+    void RenderPerfOverlay(); // 渲染性能监视窗口
+    void RecordFrameTime(uint64_t frame_ns); // 记录一帧的耗时
 
     // 布局管理相关方法
     void SetupDefaultDockingLayout(ImGuiID dockspace_id); // 设置默认停靠布局
@@ -93,6 +107,10 @@ private:
 
     // 事件处理相关方法
     void HandleMessages(); // 处理消息
+    void WaitForFrame(); // 等到需要绘制下一帧(有输入、新日志或到达空闲刷新时间)
+    void WaitEvents(double timeout_seconds); // 阻塞等待窗口消息，超时或被唤醒后返回
+    bool IsMainWindowFocused() const;
+    bool IsMainWindowMinimized() const;
     bool ShouldExit() const; // 检查是否应该退出
     static void ContentScaleCallback(GLFWwindow *window, float xscale, float yscale); // 内容缩放回调
 
@@ -107,7 +125,7 @@ private:
     void SaveCurrentTheme();
     void LoadSavedTheme();
 
-    ImVec4 GetCustomLogLevelColor(const std::string &log);
+    ImVec4 GetCustomLogLevelColor(LogLevel level);
 
     // 平台相关初始化方法
 #ifdef USE_WIN32_BACKEND
@@ -155,6 +173,13 @@ private:
     bool m_initialized = false; // 是否已初始化
     bool m_fullscreen = false;
     bool m_padding = false;
+    // 事件驱动重绘
+    static constexpr int kPowerSaveFps = 5; // 失去焦点且开启节能时的帧率上限
+    static constexpr int kSettleFrames = 3; // 每次输入后连续绘制的帧数，让悬停、滚动等状态稳定
+    static constexpr double kIdleRedrawSeconds = 0.5; // 无事件时的刷新间隔(进程状态、提示计时等)
+    static constexpr double kHiddenWaitSeconds = 0.1; // 窗口隐藏时仍定期醒来取走日志队列
+    std::chrono::steady_clock::time_point m_last_frame_time{};
+    int m_redraw_frames = kSettleFrames; // 还需连续绘制的帧数
     // DPI缩放相关
     float m_dpi_scale = 1.0f; // 当前DPI缩放
     float m_last_dpi_scale = 1.0f; // 上次DPI缩放
@@ -178,6 +203,48 @@ private:
     bool show_encoding_settings_ = false; // 是否显示编码设置
     bool show_command_history_ = false; // 是否显示命令历史
 
+    // 日志搜索
+    static constexpr size_t kMaxSearchResults = 100000;
+    char log_search_[256] = {};
+    std::vector<uint64_t> log_search_results_; // 匹配的行号(升序)
+    bool log_search_active_ = false;           // 短查询要按回车确认后才执行
+    uint64_t log_search_end_ = 0;              // 已搜索到的行号，之后只搜索新到达的行
+    uint64_t log_search_generation_ = 0;
+    double log_search_time_ = 0.0;
+    float log_search_ms_ = 0.0f;
+    int log_search_cursor_ = -1;
+    bool log_search_scroll_pending_ = false;
+    LogLineScroller log_scroll_;               // 主日志面板(含冷层时可达数千万行)
+
+    // 日志过滤视图
+    char log_filter_input_[256] = {};
+    LogFilterView log_filter_view_;
+
+    // 性能监视：帧耗时保存最近kFrameTimeSamples帧用于求分位数，其余指标每秒由PerfCounters采样相减
+    static constexpr size_t kFrameTimeSamples = 256;
+    bool show_perf_overlay_ = false;
+    std::array<float, kFrameTimeSamples> frame_times_ms_{};
+    size_t frame_time_count_ = 0;
+    PerfCounters::Sample perf_last_sample_{};
+    struct PerfRates {
+        float frame_p50_ms = 0.0f;
+        float frame_p99_ms = 0.0f;
+        double lines_per_sec = 0.0;
+        double bytes_per_sec = 0.0;
+        double conversion_ms = 0.0;     // 以下均为每秒耗时(ms)
+        double ansi_ms = 0.0;
+        double level_ms = 0.0;
+        double lock_wait_ms = 0.0;
+    } perf_rates_;
+
+    // 历史日志浏览
+    bool show_log_file_viewer_ = false;
+    std::vector<std::filesystem::path> log_files_;
+    LogFileReader log_file_reader_;
+    uint64_t log_viewer_jump_line_ = 0;
+    char log_viewer_jump_time_[32] = {};
+    LogLineScroller log_viewer_scroll_;
+
     bool m_show_theme_save_success = true;
     float m_theme_save_success_timer = 3.0f;
 
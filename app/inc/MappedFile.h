@@ -0,0 +1,38 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+
+// 只读内存映射文件
+// 映射建立后不调入任何页，只有实际访问到的页才会从文件调入
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    bool IsOpen() const { return data_ != nullptr; }
+    const char* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+    // 丢弃已调入的常驻页，映射和指针保持有效，再次访问时重新从文件调入
+    void ReleaseResident() const;
+
+private:
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // MAPPED_FILE_H
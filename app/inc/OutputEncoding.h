@@ -0,0 +1,22 @@
+#ifndef OUTPUT_ENCODING_H
+#define OUTPUT_ENCODING_H
+
+// 输出编码枚举
+enum class OutputEncoding {
+    AUTO_DETECT = 0,
+    UTF8,
+#ifdef _WIN32
+    GBK,
+    GB2312,
+    BIG5,
+    SHIFT_JIS,
+#else
+    // Unix/Linux 常见编码
+    ISO_8859_1,
+    GB18030,
+    BIG5,
+    EUC_JP,
+#endif
+};
+
+#endif // OUTPUT_ENCODING_H
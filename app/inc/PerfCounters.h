@@ -0,0 +1,60 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+inline uint64_t PerfNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 热路径的常开计数器：全部是累计值，写入只是一次relaxed的fetch_add
+// 读者(性能监视窗口、基准工具)定期调用Load()，两次采样相减得到每秒速率
+struct PerfCounters {
+    // 读取线程
+    std::atomic<uint64_t> read_bytes{0};        // ReadOutput从管道读到的字节
+    std::atomic<uint64_t> read_lines{0};        // 分行后送入接收队列的行
+    std::atomic<uint64_t> conversion_ns{0};     // 编码识别与转换
+    // 入库(UI线程)
+    std::atomic<uint64_t> ansi_ns{0};           // 去除ANSI转义序列并生成颜色段
+    std::atomic<uint64_t> level_ns{0};          // 日志级别识别
+    // 任意线程
+    std::atomic<uint64_t> logs_lock_wait_ns{0}; // 等待logs_mutex_的时间
+    // 界面
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> frame_ns{0};          // 构建并提交一帧的耗时
+
+    struct Sample {
+        uint64_t time_ns = 0;
+        uint64_t read_bytes = 0;
+        uint64_t read_lines = 0;
+        uint64_t conversion_ns = 0;
+        uint64_t ansi_ns = 0;
+        uint64_t level_ns = 0;
+        uint64_t logs_lock_wait_ns = 0;
+        uint64_t frames = 0;
+        uint64_t frame_ns = 0;
+    };
+
+    Sample Load() const;
+
+    static PerfCounters& Global();
+};
+
+// 把作用域内的耗时累加到计数器上
+class PerfTimer {
+public:
+    explicit PerfTimer(std::atomic<uint64_t>& counter) : counter_(counter), begin_(PerfNowNs()) {}
+    ~PerfTimer() { counter_.fetch_add(PerfNowNs() - begin_, std::memory_order_relaxed); }
+
+    PerfTimer(const PerfTimer&) = delete;
+    PerfTimer& operator=(const PerfTimer&) = delete;
+
+private:
+    std::atomic<uint64_t>& counter_;
+    uint64_t begin_;
+};
+
+#endif // PERF_COUNTERS_H
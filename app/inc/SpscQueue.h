@@ -0,0 +1,92 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 单生产者/单消费者无锁环形队列
+// 生产者只写 tail_，消费者只写 head_；两端各自缓存对端索引，只有缓存失效时才跨核读取
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        slots_ = std::make_unique<T[]>(cap);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 仅生产者线程调用，队列已满时返回false且不修改value
+    bool TryPush(T&& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用
+    bool TryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用：一次性取出当前可见的全部元素（最多max_items个），只发布一次head
+    template<typename Fn>
+    size_t PopBatch(Fn&& fn, size_t max_items = static_cast<size_t>(-1)) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        size_t count = cached_tail_ - head;
+        if (count > max_items) count = max_items;
+        for (size_t i = 0; i < count; ++i) {
+            fn(std::move(slots_[(head + i) & mask_]));
+        }
+        if (count > 0) {
+            head_.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // 任意线程可调用的近似深度，仅用于统计显示
+    size_t SizeApprox() const {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+
+    size_t Capacity() const { return mask_ + 1; }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    std::unique_ptr<T[]> slots_;
+    size_t mask_ = 0;
+
+    // 消费者侧
+    alignas(kCacheLine) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    // 生产者侧
+    alignas(kCacheLine) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+};
+
+#endif // SPSC_QUEUE_H
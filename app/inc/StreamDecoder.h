@@ -0,0 +1,37 @@
+#ifndef STREAM_DECODER_H
+#define STREAM_DECODER_H
+
+#include <string>
+#include <string_view>
+
+#include "EncodingDetector.h"
+#include "OutputEncoding.h"
+
+// 管道字节流的分块解码器
+// read()得到的块可能在多字节字符中间截断：每次只交出以完整字符结尾的前缀，截断的尾部留到下一块拼接，
+// 因此每块只需校验/转换一次。自动检测模式下由EncodingDetector确定本块的实际编码，转换时不再反复尝试
+class StreamDecoder {
+public:
+    struct Piece {
+        std::string_view bytes;     // 可完整解码的字节，在下一次Take/Flush前有效
+        OutputEncoding encoding;    // 实际编码，不会是AUTO_DETECT
+    };
+
+    Piece Take(std::string_view chunk, OutputEncoding requested);
+    // 输出结束时交出残留的字节(可能是不完整的字符)
+    Piece Flush();
+    void Reset();
+
+    // 自动检测的当前结论
+    EncodingDetector::Result Detection() const { return detector_.Current(); }
+
+private:
+    static size_t CompleteLength(std::string_view data, OutputEncoding encoding);
+
+    std::string carry_;
+    std::string joined_;
+    EncodingDetector detector_;
+    OutputEncoding last_encoding_ = OutputEncoding::UTF8;
+};
+
+#endif // STREAM_DECODER_H
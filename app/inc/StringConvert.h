@@ -0,0 +1,10 @@
+#ifndef STRING_CONVERT_H
+#define STRING_CONVERT_H
+
+#include <string>
+
+// UTF-8与宽字符串互转(Windows上为UTF-16，其余平台wchar_t为UTF-32)
+std::wstring StringToWide(const std::string& str);
+std::string WideToString(const std::wstring& wstr);
+
+#endif // STRING_CONVERT_H
@@ -0,0 +1,39 @@
+#ifndef TRANSCODE_TABLES_H
+#define TRANSCODE_TABLES_H
+
+#include <cstdint>
+
+// 多字节编码到Unicode的查找表，数据由tools/gen_transcode_tables.py生成(TranscodeTables.cpp)
+// 双字节表按 (首字节序号 * kTrailCount + 第二字节 - kTrailBegin) 索引，0表示未定义
+namespace transcode_tables {
+    constexpr unsigned kTrailBegin = 0x40;
+    constexpr unsigned kTrailCount = 0xFF - kTrailBegin;    // 第二字节 0x40-0xFE
+
+    // GBK/CP936双字节区(首字节0x81-0xFE)，与Windows的MultiByteToWideChar(936)一致，含用户自定义区
+    extern const uint16_t kGbkTwoByte[126 * kTrailCount];
+    // GB18030-2022双字节区(首字节0x81-0xFE)，与glibc iconv一致；BMP以外的码点见kGb18030TwoByteSupplementary
+    extern const uint16_t kGb18030TwoByte[126 * kTrailCount];
+    // Big5/CP950(首字节0x81-0xFE)，含CP950用户自定义区
+    extern const uint16_t kBig5TwoByte[126 * kTrailCount];
+    // Shift-JIS/CP932(首字节0x81-0x9F、0xE0-0xFC，依次编号)
+    extern const uint16_t kShiftJisTwoByte[60 * kTrailCount];
+    // Shift-JIS单字节0x80-0xFF(半角片假名等)
+    extern const uint16_t kShiftJisSingleByte[128];
+
+    // GB18030双字节区中映射到BMP以外的码(均在首字节0xFE下)，双字节表中对应位置为0
+    struct Gb18030Supplementary {
+        uint16_t code;
+        uint32_t code_point;
+    };
+    extern const Gb18030Supplementary kGb18030TwoByteSupplementary[6];
+
+    // GB18030四字节区的BMP部分：线性序号 [index, index + length) 对应码点 [code_point, ...)
+    struct Gb18030Range {
+        uint32_t index;
+        uint32_t length;
+        uint32_t code_point;
+    };
+    extern const Gb18030Range kGb18030Ranges[210];
+}
+
+#endif // TRANSCODE_TABLES_H
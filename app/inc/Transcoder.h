@@ -0,0 +1,18 @@
+#ifndef TRANSCODER_H
+#define TRANSCODER_H
+
+#include <string>
+#include <string_view>
+
+#include "OutputEncoding.h"
+
+// 不依赖系统API的多字节编码 -> UTF-8 转换
+// 查表直接输出UTF-8，不经过宽字符中间串；ASCII连续段按16字节整块复制。Windows与Linux输出一致。
+// 支持GBK(CP936)、GB18030、Big5(CP950)、Shift-JIS(CP932)和ISO-8859-1，其余编码返回false由系统转换接口处理
+bool CanTranscodeToUtf8(OutputEncoding encoding);
+
+// 结果写入buffer(只扩容不缩小，可跨调用复用)，返回值指向buffer，在下一次调用前有效。
+// 输入应以完整字符结尾(见StreamDecoder)，无法解码的字节输出U+FFFD
+std::string_view TranscodeToUtf8(std::string_view input, OutputEncoding encoding, std::string& buffer);
+
+#endif // TRANSCODER_H
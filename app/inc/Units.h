@@ -1,26 +1,54 @@
 #ifndef UNITS_H
 #define UNITS_H
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <imgui.h>
 #include <vector>
 
-std::wstring StringToWide(const std::string& str);
-std::string WideToString(const std::wstring& wstr);
+#include "LogLine.h"
+#include "StringConvert.h"
+
 void SetAutoStart(bool enable);
 bool IsAutoStartEnabled();
 
-// 结构体定义
-struct ColoredTextSegment {
-    std::string text;   // 文本内容
-    ImVec4 color;      // 文本颜色
-};
-
 // 日志颜色处理方法
-ImVec4 GetLogLevelColor(const std::string &log);       // 获取日志级别颜色
-void RenderColoredLogLine(const std::string &log);     // 渲染彩色日志行
-std::vector<ColoredTextSegment> ParseAnsiColorCodes(const std::string &text);  // 解析ANSI颜色代码
-std::pair<ImVec4, bool>
-ParseAnsiColorCode(const std::string &code, const ImVec4 &currentColor, bool currentBold);  // 解析单个ANSI颜色代码
-ImVec4 GetAnsiColor(int colorIndex, bool bright);      // 获取ANSI颜色
+ImVec4 GetLogLevelColor(LogLevel level);              // 获取日志级别的默认颜色
+void RenderColoredLogLine(const LogLineView& line);    // 按入库时解析好的颜色段渲染日志行
+
+// 超长列表的按行滚动
+// ImGui的滚动位置是float、ListClipper的行数是int：几百万行之后按像素定位会落到错误的行，超过2^31的行无法显示。
+// 这里不使用子窗口的纵向滚动，由64位的首行号决定显示哪些行：滚轮和按键按行移动，右侧的位置条按行号定位。
+// 用法：列表子窗口宽度留出ScrollbarWidth()并带ImGuiWindowFlags_NoScrollWithMouse，在其中调用Begin，
+// 绘制First()起的Count()行；EndChild后SameLine再调用DrawScrollbar
+class LogLineScroller {
+public:
+    static constexpr int kWheelLines = 3;
+
+    static float ScrollbarWidth();
+
+    // follow_end为true且上一帧停在末尾时，随新增的行停留在末尾
+    void Begin(uint64_t total_rows, bool follow_end);
+    uint64_t First() const { return first_; }
+    int Count() const { return count_; }
+    // 本帧开始时是否停在末尾
+    bool AtEnd() const { return at_end_; }
+
+    // 定位到指定行，align为该行在可见区域中的位置(0顶部，0.5居中，1底部)，在下一次Begin中生效
+    void ScrollTo(uint64_t row, float align);
+    void DrawScrollbar(const char* id, float height);
+
+private:
+    uint64_t MaxFirst() const { return total_ > static_cast<uint64_t>(count_) ? total_ - count_ : 0; }
+
+    uint64_t first_ = 0;
+    uint64_t total_ = 0;
+    int count_ = 0;
+    bool at_end_ = true;
+
+    bool target_pending_ = false;
+    uint64_t target_row_ = 0;
+    float target_align_ = 0.0f;
+};
 
 #endif //UNITS_H
@@ -0,0 +1,17 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstddef>
+#include <string_view>
+
+// 检查是否为有效的UTF-8(严格遵循RFC 3629：拒绝超长编码、代理区码点和大于U+10FFFF的码点)
+// 运行时按CPU选择AVX2/SSE2/标量实现
+bool IsValidUTF8(std::string_view str);
+
+// 标量实现，供无SIMD的平台和对照使用
+bool IsValidUTF8Scalar(std::string_view str);
+
+// 末尾被截断的多字节序列的字节数(0表示以完整字符结尾)
+size_t Utf8IncompleteTail(std::string_view str);
+
+#endif // UTF8_H
@@ -0,0 +1,91 @@
+#include "AnsiParser.h"
+
+#include <algorithm>
+
+uint32_t AnsiStyle::Color() const {
+    switch (fg_kind) {
+        case ColorKind::Indexed: {
+            if (bold && fg_index < 8) {
+                // 粗体的基本色提亮(每个分量+0.3)
+                uint32_t color = kAnsiPalette[fg_index];
+                uint32_t result = 0xFF000000u;
+                for (int shift = 0; shift < 24; shift += 8) {
+                    const uint32_t channel = std::min<uint32_t>(255, ((color >> shift) & 0xFF) + 77);
+                    result |= channel << shift;
+                }
+                return result;
+            }
+            return kAnsiPalette[fg_index];
+        }
+        case ColorKind::Rgb:
+            return fg_rgb;
+        default:
+            return kAnsiDefaultColor;
+    }
+}
+
+void AnsiStyle::Apply(const uint16_t* params, size_t count, uint32_t subparams) {
+    for (size_t k = 0; k < count; ++k) {
+        const uint16_t code = params[k];
+        // 紧随其后的冒号子参数与该参数同属一组，处理完整组一起跳过
+        size_t sub_count = 0;
+        while (k + 1 + sub_count < count && (subparams >> (k + 1 + sub_count)) & 1) ++sub_count;
+        const uint16_t* sub = params + k + 1;
+        k += sub_count;
+
+        if ((code == 38 || code == 48) && sub_count > 0) {
+            // 冒号格式：38:5:n，38:2:色彩空间:r:g:b；色彩空间一项可以为空(38:2::r:g:b)，
+            // 也有程序省略这一项(38:2:r:g:b)，按子参数个数区分。多出的子参数(容差等)忽略
+            if (code == 48) continue;
+            if (sub[0] == 5 && sub_count >= 2) {
+                fg_kind = ColorKind::Indexed;
+                fg_index = static_cast<uint8_t>(std::min<uint16_t>(sub[1], 255));
+            } else if (sub[0] == 2 && sub_count >= 4) {
+                const uint16_t* rgb = sub_count >= 5 ? sub + 2 : sub + 1;
+                fg_kind = ColorKind::Rgb;
+                fg_rgb = AnsiPackColor(std::min<uint16_t>(rgb[0], 255), std::min<uint16_t>(rgb[1], 255),
+                                       std::min<uint16_t>(rgb[2], 255));
+            }
+            continue;
+        }
+
+        if (code == 0) {
+            *this = AnsiStyle();
+        } else if (code == 1) {
+            bold = true;
+        } else if (code == 22) {
+            bold = false;
+        } else if (code >= 30 && code <= 37) {
+            fg_kind = ColorKind::Indexed;
+            fg_index = static_cast<uint8_t>(code - 30);
+        } else if (code >= 90 && code <= 97) {
+            fg_kind = ColorKind::Indexed;
+            fg_index = static_cast<uint8_t>(code - 90 + 8);
+        } else if (code == 39) {
+            fg_kind = ColorKind::Default;
+        } else if (code == 38 || code == 48) {
+            // 分号格式的扩展颜色：38;5;n(256色) 或 38;2;r;g;b(真彩色)；背景色(48)只消耗参数不显示
+            if (k + 1 >= count) break;
+            const uint16_t mode = params[k + 1];
+            if (mode == 5 && k + 2 < count) {
+                if (code == 38) {
+                    fg_kind = ColorKind::Indexed;
+                    fg_index = static_cast<uint8_t>(std::min<uint16_t>(params[k + 2], 255));
+                }
+                k += 2;
+            } else if (mode == 2 && k + 4 < count) {
+                if (code == 38) {
+                    fg_kind = ColorKind::Rgb;
+                    fg_rgb = AnsiPackColor(std::min<uint16_t>(params[k + 2], 255),
+                                           std::min<uint16_t>(params[k + 3], 255),
+                                           std::min<uint16_t>(params[k + 4], 255));
+                }
+                k += 4;
+            } else {
+                // 无法识别的扩展格式，忽略本序列余下的参数
+                break;
+            }
+        }
+        // 背景色(40-47、49、100-107)和其他属性暂不显示；其他参数的子参数(如4:3波浪下划线)已整组跳过
+    }
+}
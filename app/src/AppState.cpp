@@ -1,7 +1,19 @@
 #include "AppState.h"
 #include <fstream>
 #include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <string_view>
+
+namespace {
+    // 复制到定长缓冲区，超长截断并保证以NUL结尾(代替仅MSVC/MinGW提供的strcpy_s/strncpy_s)
+    template<size_t N>
+    void CopyToBuffer(char (&dest)[N], std::string_view src) {
+        const size_t length = std::min(src.size(), N - 1);
+        memcpy(dest, src.data(), length);
+        dest[length] = '\0';
+    }
+}
 
 AppState::AppState() :
     show_main_window(true),
@@ -9,16 +21,27 @@ AppState::AppState() :
     auto_scroll_logs(true),
     auto_working_dir(true),
     enable_colored_logs(true),
-    max_log_lines(1000),
+    max_log_lines(0),
+    max_log_bytes(64ull * 1024 * 1024),
+    enable_search_index(true),
+    enable_cold_log_tier(false),
+    max_cold_log_bytes(4ull * 1024 * 1024 * 1024),
+    enable_log_file(false),
+    log_file_max_mb(64),
+    log_file_max_age_min(60),
+    compress_log_files(false),
     stop_timeout_ms(5000),
     use_stop_command(false),
     use_custom_environment(false),
     output_encoding(OutputEncoding::AUTO_DETECT),
     max_command_history(20), // 新增：最大历史记录数量
+    max_fps(60),
+    power_save_unfocused(true),
     settings_dirty(false) {
-    strcpy_s(command_input, "cmd.exe");
-    strcpy_s(web_url, "http://localhost:8080");
-    strcpy_s(stop_command, "exit");
+    CopyToBuffer(command_input, "cmd.exe");
+    CopyToBuffer(web_url, "http://localhost:8080");
+    CopyToBuffer(stop_command, "exit");
+    CopyToBuffer(log_file_directory, "logs");
     memset(send_command, 0, sizeof(send_command));
 }
 
@@ -217,7 +240,7 @@ void AppState::DeserializeLogColors(const std::string& serialized) {
             }
         }
 
-        ImVec4 color(rgba[0], rgba[1], rgba[2], rgba[3]);
+        LogColor color{rgba[0], rgba[1], rgba[2], rgba[3]};
 
         switch (colorIndex) {
             case 0: log_colors.error_color = color; break;
@@ -260,14 +283,45 @@ void AppState::LoadSettings() {
                 std::string value = line.substr(pos + 1);
 
                 if (key == "CommandInput") {
-                    strncpy_s(command_input, value.c_str(), sizeof(command_input) - 1);
+                    CopyToBuffer(command_input, value);
                 }
                 else if (key == "WorkingDirectory") {
-                    strncpy_s(working_directory, value.c_str(), sizeof(working_directory) - 1);
+                    CopyToBuffer(working_directory, value);
                 }
-                else if (key == "MaxLogLines") {
+                // 旧版本总会把100~10000之间的MaxLogLines写回设置文件，沿用它会让升级后的安装
+                // 一直停留在行数上限而用不上字节预算，因此忽略旧键，可选行数上限改用MaxLogLineCap
+                else if (key == "MaxLogLineCap") {
                     max_log_lines = std::stoi(value);
-                    max_log_lines = std::max(100, std::min(max_log_lines, 10000));
+                    max_log_lines = std::max(0, max_log_lines);
+                }
+                else if (key == "MaxLogBytes") {
+                    max_log_bytes = std::stoull(value);
+                    max_log_bytes = std::max<uint64_t>(1ull << 20, std::min<uint64_t>(max_log_bytes, 16ull << 30));
+                }
+                else if (key == "EnableSearchIndex") {
+                    enable_search_index = (value == "1");
+                }
+                else if (key == "EnableColdLogTier") {
+                    enable_cold_log_tier = (value == "1");
+                }
+                else if (key == "MaxColdLogBytes") {
+                    max_cold_log_bytes = std::stoull(value);
+                    max_cold_log_bytes = std::max<uint64_t>(64ull << 20, max_cold_log_bytes);
+                }
+                else if (key == "EnableLogFile") {
+                    enable_log_file = (value == "1");
+                }
+                else if (key == "LogFileDirectory") {
+                    CopyToBuffer(log_file_directory, value);
+                }
+                else if (key == "LogFileMaxMB") {
+                    log_file_max_mb = std::max(1, std::min(std::stoi(value), 4096));
+                }
+                else if (key == "LogFileMaxAgeMin") {
+                    log_file_max_age_min = std::max(0, std::stoi(value));
+                }
+                else if (key == "CompressLogFiles") {
+                    compress_log_files = (value == "1");
                 }
                 else if (key == "AutoScrollLogs") {
                     auto_scroll_logs = (value == "1");
@@ -282,10 +336,10 @@ void AppState::LoadSettings() {
                     auto_working_dir = (value == "1");
                 }
                 else if (key == "WebUrl") {
-                    strncpy_s(web_url, value.c_str(), sizeof(web_url) - 1);
+                    CopyToBuffer(web_url, value);
                 }
                 else if (key == "StopCommand") {
-                    strncpy_s(stop_command, value.c_str(), sizeof(stop_command) - 1);
+                    CopyToBuffer(stop_command, value);
                 }
                 else if (key == "StopTimeoutMs") {
                     stop_timeout_ms = std::stoi(value);
@@ -319,6 +373,12 @@ void AppState::LoadSettings() {
                 else if (key == "LogColors") {
                     DeserializeLogColors(value);
                 }
+                else if (key == "MaxFps") {
+                    max_fps = std::max(10, std::min(std::stoi(value), 240));
+                }
+                else if (key == "PowerSaveUnfocused") {
+                    power_save_unfocused = (value == "1");
+                }
             }
         }
     }
@@ -332,7 +392,16 @@ void AppState::SaveSettings() {
     file << "[Settings]\n";
     file << "CommandInput=" << command_input << "\n";
     file << "WorkingDirectory=" << working_directory << "\n";
-    file << "MaxLogLines=" << max_log_lines << "\n";
+    file << "MaxLogLineCap=" << max_log_lines << "\n";
+    file << "MaxLogBytes=" << max_log_bytes << "\n";
+    file << "EnableSearchIndex=" << (enable_search_index ? "1" : "0") << "\n";
+    file << "EnableColdLogTier=" << (enable_cold_log_tier ? "1" : "0") << "\n";
+    file << "MaxColdLogBytes=" << max_cold_log_bytes << "\n";
+    file << "EnableLogFile=" << (enable_log_file ? "1" : "0") << "\n";
+    file << "LogFileDirectory=" << log_file_directory << "\n";
+    file << "LogFileMaxMB=" << log_file_max_mb << "\n";
+    file << "LogFileMaxAgeMin=" << log_file_max_age_min << "\n";
+    file << "CompressLogFiles=" << (compress_log_files ? "1" : "0") << "\n";
     file << "AutoScrollLogs=" << (auto_scroll_logs ? "1" : "0") << "\n";
     file << "EnableColoredLogs=" << (enable_colored_logs ? "1" : "0") << "\n";
     file << "AutoStart=" << (auto_start ? "1" : "0") << "\n";
@@ -358,13 +427,18 @@ void AppState::SaveSettings() {
     file << "UseCustomLogColors=" << (use_custom_log_colors ? "1" : "0") << "\n";
     file << "UseAnsiColors=" << (use_ansi_colors ? "1" : "0") << "\n";
     file << "LogColors=" << SerializeLogColors() << "\n";
+    file << "MaxFps=" << max_fps << "\n";
+    file << "PowerSaveUnfocused=" << (power_save_unfocused ? "1" : "0") << "\n";
     file.close();
 
     settings_dirty = false;
 }
 
 void AppState::ApplySettings() {
+    cli_process.SetMaxLogBytes(max_log_bytes);
     cli_process.SetMaxLogLines(max_log_lines);
+    cli_process.SetSearchIndexEnabled(enable_search_index);
+    cli_process.SetColdLogTier(enable_cold_log_tier, max_cold_log_bytes);
 
     // 应用停止命令设置
     if (use_stop_command && strlen(stop_command) > 0) {
@@ -388,3 +462,13 @@ void AppState::ApplySettings() {
     // 应用输出编码设置
     cli_process.SetOutputEncoding(output_encoding);
 }
+
+// 日志文件配置变化时重启写入，新配置从新文件开始生效；不随ApplySettings调用，只在启动时和日志文件设置变化时调用
+void AppState::ApplyLogFileSettings() {
+    LogFileSinkConfig config;
+    config.directory = strlen(log_file_directory) > 0 ? log_file_directory : "logs";
+    config.max_file_bytes = static_cast<uint64_t>(log_file_max_mb) << 20;
+    config.max_file_age = std::chrono::minutes(log_file_max_age_min);
+    config.compress_closed = compress_log_files;
+    cli_process.SetLogFile(enable_log_file, config);
+}
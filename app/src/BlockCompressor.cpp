@@ -0,0 +1,246 @@
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+    constexpr int kHashBits = 14;
+    constexpr size_t kMinMatch = 4;
+    constexpr size_t kMaxOffset = 65535;
+    constexpr size_t kLastLiterals = 5;     // 块尾保留为字面量的字节数
+    constexpr size_t kMatchSearchEnd = 12;  // 距块尾不足该长度时不再寻找匹配
+    constexpr size_t kFileBlockSize = 1024 * 1024;
+    constexpr uint32_t kStoredFlag = 0x80000000u;
+    constexpr char kFileMagic[4] = {'L', 'Z', 'B', '1'};
+
+    uint32_t Read32(const uint8_t* p) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Hash(uint32_t value) {
+        return (value * 2654435761u) >> (32 - kHashBits);
+    }
+
+    // 写入长度扩展字节：每个255表示继续
+    bool WriteLength(uint8_t*& op, const uint8_t* oend, size_t length) {
+        while (length >= 255) {
+            if (op >= oend) return false;
+            *op++ = 255;
+            length -= 255;
+        }
+        if (op >= oend) return false;
+        *op++ = static_cast<uint8_t>(length);
+        return true;
+    }
+
+    bool ReadLength(const uint8_t*& ip, const uint8_t* iend, size_t& length) {
+        uint8_t byte;
+        do {
+            if (ip >= iend) return false;
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    bool EmitSequence(uint8_t*& op, const uint8_t* oend,
+                      const uint8_t* literals, size_t literal_length,
+                      size_t offset, size_t match_length) {
+        if (op >= oend) return false;
+        uint8_t* token = op++;
+        *token = static_cast<uint8_t>(std::min<size_t>(literal_length, 15) << 4);
+        if (literal_length >= 15 && !WriteLength(op, oend, literal_length - 15)) return false;
+
+        if (static_cast<size_t>(oend - op) < literal_length) return false;
+        memcpy(op, literals, literal_length);
+        op += literal_length;
+
+        // 块尾序列只有字面量
+        if (match_length == 0) return true;
+
+        if (oend - op < 2) return false;
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+
+        const size_t match_code = match_length - kMinMatch;
+        *token |= static_cast<uint8_t>(std::min<size_t>(match_code, 15));
+        if (match_code >= 15 && !WriteLength(op, oend, match_code - 15)) return false;
+        return true;
+    }
+
+    void WriteU32(std::ofstream& file, uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool ReadU32(std::ifstream& file, uint32_t& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+}
+
+size_t BlockCompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t BlockCompress(const char* src, size_t size, char* dst, size_t capacity) {
+    const uint8_t* const base = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* const iend = base + size;
+    const uint8_t* ip = base;
+    const uint8_t* anchor = base;
+    uint8_t* op = reinterpret_cast<uint8_t*>(dst);
+    const uint8_t* const oend = op + capacity;
+
+    if (size >= kMatchSearchEnd) {
+        std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+        const uint8_t* const search_end = iend - kMatchSearchEnd;
+        const uint8_t* const match_end = iend - kLastLiterals;
+        size_t misses = 0;
+
+        while (ip < search_end) {
+            const uint32_t value = Read32(ip);
+            const uint32_t hash = Hash(value);
+            const uint8_t* candidate = base + table[hash];
+            table[hash] = static_cast<uint32_t>(ip - base);
+
+            if (candidate < ip && static_cast<size_t>(ip - candidate) <= kMaxOffset && Read32(candidate) == value) {
+                const uint8_t* match = ip + kMinMatch;
+                const uint8_t* ref = candidate + kMinMatch;
+                while (match < match_end && *match == *ref) {
+                    ++match;
+                    ++ref;
+                }
+
+                if (!EmitSequence(op, oend, anchor, static_cast<size_t>(ip - anchor),
+                                  static_cast<size_t>(ip - candidate), static_cast<size_t>(match - ip))) {
+                    return 0;
+                }
+                ip = match;
+                anchor = ip;
+                misses = 0;
+            } else {
+                // 连续未命中时逐渐加大步长，不可压缩数据上保持线性速度
+                ip += 1 + (misses++ >> 6);
+            }
+        }
+    }
+
+    if (!EmitSequence(op, oend, anchor, static_cast<size_t>(iend - anchor), 0, 0)) {
+        return 0;
+    }
+    return static_cast<size_t>(op - reinterpret_cast<uint8_t*>(dst));
+}
+
+size_t BlockDecompress(const char* src, size_t size, char* dst, size_t capacity) {
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* const iend = ip + size;
+    uint8_t* const obase = reinterpret_cast<uint8_t*>(dst);
+    uint8_t* op = obase;
+    const uint8_t* const oend = op + capacity;
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !ReadLength(ip, iend, literal_length)) return 0;
+        if (static_cast<size_t>(iend - ip) < literal_length || static_cast<size_t>(oend - op) < literal_length) {
+            return 0;
+        }
+        memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return 0;
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - obase)) return 0;
+
+        size_t match_length = token & 15;
+        if (match_length == 15 && !ReadLength(ip, iend, match_length)) return 0;
+        match_length += kMinMatch;
+        if (static_cast<size_t>(oend - op) < match_length) return 0;
+
+        // 偏移小于长度时源与目标重叠，需逐字节复制
+        const uint8_t* ref = op - offset;
+        if (offset >= match_length) {
+            memcpy(op, ref, match_length);
+            op += match_length;
+        } else {
+            for (size_t i = 0; i < match_length; ++i) {
+                *op++ = *ref++;
+            }
+        }
+    }
+    return static_cast<size_t>(op - obase);
+}
+
+bool CompressFile(const std::filesystem::path& input, const std::filesystem::path& output) {
+    std::ifstream in(input, std::ios::binary);
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!in.is_open() || !out.is_open()) return false;
+
+    std::vector<char> raw(kFileBlockSize);
+    std::vector<char> packed(BlockCompressBound(kFileBlockSize));
+    out.write(kFileMagic, sizeof(kFileMagic));
+
+    while (in) {
+        in.read(raw.data(), static_cast<std::streamsize>(raw.size()));
+        const size_t raw_size = static_cast<size_t>(in.gcount());
+        if (raw_size == 0) break;
+
+        const size_t packed_size = BlockCompress(raw.data(), raw_size, packed.data(), packed.size());
+        WriteU32(out, static_cast<uint32_t>(raw_size));
+        if (packed_size == 0 || packed_size >= raw_size) {
+            WriteU32(out, static_cast<uint32_t>(raw_size) | kStoredFlag);
+            out.write(raw.data(), static_cast<std::streamsize>(raw_size));
+        } else {
+            WriteU32(out, static_cast<uint32_t>(packed_size));
+            out.write(packed.data(), static_cast<std::streamsize>(packed_size));
+        }
+    }
+    WriteU32(out, 0);
+    WriteU32(out, 0);
+
+    out.close();
+    return !in.bad() && !out.fail();
+}
+
+bool DecompressFile(const std::filesystem::path& input, const std::filesystem::path& output) {
+    std::ifstream in(input, std::ios::binary);
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!in.is_open() || !out.is_open()) return false;
+
+    char magic[sizeof(kFileMagic)];
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, kFileMagic, sizeof(magic)) != 0) return false;
+
+    std::vector<char> raw(kFileBlockSize);
+    std::vector<char> packed(BlockCompressBound(kFileBlockSize));
+
+    while (true) {
+        uint32_t raw_size = 0;
+        uint32_t stored = 0;
+        if (!ReadU32(in, raw_size) || !ReadU32(in, stored)) return false;
+        if (raw_size == 0) break;
+
+        const bool is_stored = (stored & kStoredFlag) != 0;
+        const size_t stored_size = stored & ~kStoredFlag;
+        if (raw_size > raw.size() || stored_size > packed.size()) return false;
+        if (!in.read(packed.data(), static_cast<std::streamsize>(stored_size))) return false;
+
+        if (is_stored) {
+            if (stored_size != raw_size) return false;
+            out.write(packed.data(), static_cast<std::streamsize>(stored_size));
+        } else {
+            if (BlockDecompress(packed.data(), stored_size, raw.data(), raw_size) != raw_size) return false;
+            out.write(raw.data(), static_cast<std::streamsize>(raw_size));
+        }
+    }
+
+    out.close();
+    return !out.fail();
+}
@@ -1,19 +1,24 @@
 #include "CLIProcess.h"
+#include "LineFramer.h"
+#include "PerfCounters.h"
+#include "StreamDecoder.h"
+#include "StringConvert.h"
+#include "Transcoder.h"
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
 
-#ifdef _WIN32
-#include "Units.h"
-#else
+#ifndef _WIN32
 #include <iconv.h>
 #include <locale.h>
 #include <langinfo.h>
+#include <poll.h>
 #include <spawn.h>
 extern char **environ;
 #endif
 
-CLIProcess::CLIProcess() {
+CLIProcess::CLIProcess() : ingest_queue_(kIngestQueueCapacity) {
 #ifdef _WIN32
     ZeroMemory(&pi_, sizeof(pi_));
     hWritePipe_stdin_ = nullptr;
@@ -21,9 +26,12 @@ CLIProcess::CLIProcess() {
     process_pid_ = -1;
     pipe_stdout_[0] = pipe_stdout_[1] = -1;
     pipe_stdin_[0] = pipe_stdin_[1] = -1;
+    stop_pipe_[0] = stop_pipe_[1] = -1;
     process_running_ = false;
 #endif
-    max_log_lines_ = 1000;
+    max_log_lines_ = 0;
+    max_log_bytes_ = 64ull * 1024 * 1024;
+    logs_.SetLimits(static_cast<size_t>(max_log_bytes_), 0);
     stop_timeout_ms_ = 5000;
     output_encoding_ = OutputEncoding::AUTO_DETECT;
     use_auto_working_dir_ = true; // 自动工作目录
@@ -32,6 +40,13 @@ CLIProcess::CLIProcess() {
 CLIProcess::~CLIProcess() {
     Stop();
     CleanupResources();
+#ifndef _WIN32
+    for (auto& [name, cd] : iconv_descriptors_) {
+        if (cd != reinterpret_cast<iconv_t>(-1)) {
+            iconv_close(cd);
+        }
+    }
+#endif
 }
 void CLIProcess::SetAutoWorkingDir(const bool auto_dir) {
     use_auto_working_dir_ = auto_dir;
@@ -152,6 +167,12 @@ OutputEncoding CLIProcess::GetOutputEncoding() const {
     return output_encoding_;
 }
 
+// 自动检测模式下识别出的编码
+EncodingDetector::Result CLIProcess::GetDetectedEncoding() const {
+    std::lock_guard<std::mutex> lock(encoding_mutex_);
+    return detected_encoding_;
+}
+
 // 获取编码名称
 std::string CLIProcess::GetEncodingName(const OutputEncoding encoding) {
     switch (encoding) {
@@ -191,6 +212,7 @@ std::vector<std::pair<OutputEncoding, std::string>> CLIProcess::GetSupportedEnco
     };
 }
 
+#ifdef _WIN32
 // 根据编码获取代码页
 UINT CLIProcess::GetCodePageFromEncoding(const OutputEncoding encoding) {
     switch (encoding) {
@@ -202,36 +224,11 @@ UINT CLIProcess::GetCodePageFromEncoding(const OutputEncoding encoding) {
     }
 }
 
-// 检查是否为有效的UTF-8
-bool CLIProcess::IsValidUTF8(const std::string& str) {
-    const auto* bytes = reinterpret_cast<const unsigned char*>(str.c_str());
-    size_t len = str.length();
-
-    for (size_t i = 0; i < len; ) {
-        if (bytes[i] <= 0x7F) {
-            // ASCII字符
-            i++;
-        } else if ((bytes[i] & 0xE0) == 0xC0) {
-            // 2字节UTF-8序列
-            if (i + 1 >= len || (bytes[i + 1] & 0xC0) != 0x80) return false;
-            i += 2;
-        } else if ((bytes[i] & 0xF0) == 0xE0) {
-            // 3字节UTF-8序列
-            if (i + 2 >= len || (bytes[i + 1] & 0xC0) != 0x80 || (bytes[i + 2] & 0xC0) != 0x80) return false;
-            i += 3;
-        } else if ((bytes[i] & 0xF8) == 0xF0) {
-            // 4字节UTF-8序列
-            if (i + 3 >= len || (bytes[i + 1] & 0xC0) != 0x80 || (bytes[i + 2] & 0xC0) != 0x80 || (bytes[i + 3] & 0xC0) != 0x80) return false;
-            i += 4;
-        } else {
-            return false;
-        }
-    }
-    return true;
-}
-
 // 转换到UTF-8
-std::string CLIProcess::ConvertToUTF8(std::string& input, const OutputEncoding encoding) {
+// 多字节代码页中每个字节最多产生一个UTF-16单元，每个UTF-16单元最多对应3字节UTF-8：
+// 两个缓冲区按最坏情况一次扩容到位(之后跨调用复用)，不再先询问长度，每个方向只调用一次系统接口
+std::string_view CLIProcess::ConvertToUTF8(std::string_view input, const OutputEncoding encoding,
+                                           std::wstring& wide_buffer, std::string& buffer) {
     if (input.empty()) return input;
 
     // 如果已经是UTF-8编码，直接返回
@@ -239,62 +236,99 @@ std::string CLIProcess::ConvertToUTF8(std::string& input, const OutputEncoding e
         return input;
     }
 
-    UINT codePage = GetCodePageFromEncoding(encoding);
+    const UINT codePage = GetCodePageFromEncoding(encoding);
+    if (wide_buffer.size() < input.size()) wide_buffer.resize(input.size());
+    if (buffer.size() < input.size() * 3) buffer.resize(input.size() * 3);
 
-    // 先转换为宽字符
-    int wideSize = MultiByteToWideChar(codePage, 0, input.c_str(), -1, nullptr, 0);
+    // 全程使用显式长度，输入中的NUL字节不会截断转换
+    const int wideSize = MultiByteToWideChar(codePage, 0, input.data(), static_cast<int>(input.size()),
+                                             wide_buffer.data(), static_cast<int>(wide_buffer.size()));
     if (wideSize <= 0) {
-        // 转换失败，返回原始字符串
+        // 转换失败，返回原始内容
         return input;
     }
 
-    std::vector<wchar_t> wideStr(wideSize);
-    if (MultiByteToWideChar(codePage, 0, input.c_str(), -1, wideStr.data(), wideSize) <= 0) {
-        return input;
-    }
-
-    // 再从宽字符转换为UTF-8
-    int utf8Size = WideCharToMultiByte(CP_UTF8, 0, wideStr.data(), -1, nullptr, 0, nullptr, nullptr);
+    const int utf8Size = WideCharToMultiByte(CP_UTF8, 0, wide_buffer.data(), wideSize,
+                                             buffer.data(), static_cast<int>(buffer.size()), nullptr, nullptr);
     if (utf8Size <= 0) {
         return input;
     }
 
-    std::vector<char> utf8Str(utf8Size);
-    if (WideCharToMultiByte(CP_UTF8, 0, wideStr.data(), -1, utf8Str.data(), utf8Size, nullptr, nullptr) <= 0) {
-        return input;
+    return {buffer.data(), static_cast<size_t>(utf8Size)};
+}
+#else
+// 获取iconv使用的编码名
+std::string CLIProcess::GetUnixEncodingName(const OutputEncoding encoding) {
+    switch (encoding) {
+        case OutputEncoding::ISO_8859_1: return "ISO-8859-1";
+        case OutputEncoding::GB18030: return "GB18030";
+        case OutputEncoding::BIG5: return "BIG5";
+        case OutputEncoding::EUC_JP: return "EUC-JP";
+        default: return "UTF-8";
     }
-
-    return std::string(utf8Str.data());
 }
 
-// 自动检测并转换到UTF-8
-std::string CLIProcess::DetectAndConvertToUTF8(std::string& input) {
+// 转换到UTF-8
+// 每种编码只打开一次iconv描述符并在各次读取间复用(转换状态随之保留)，结果写入复用的输出缓冲区，
+// 返回值在下一次调用前有效。只由读取线程调用
+std::string_view CLIProcess::ConvertUnixEncoding(std::string_view input, const std::string& from_encoding) {
     if (input.empty()) return input;
 
-    // 首先检查是否已经是有效的UTF-8
-    if (IsValidUTF8(input)) {
+    auto it = iconv_descriptors_.find(from_encoding);
+    if (it == iconv_descriptors_.end()) {
+        // 打开失败也缓存下来，避免每块都重试
+        it = iconv_descriptors_.emplace(from_encoding, iconv_open("UTF-8", from_encoding.c_str())).first;
+    }
+    iconv_t cd = it->second;
+    if (cd == reinterpret_cast<iconv_t>(-1)) {
+        // 系统不支持该编码，原样返回
         return input;
     }
 
-    // 尝试不同的编码进行转换
-    const std::vector encodingsToTry = {
-        OutputEncoding::GBK,
-        OutputEncoding::GB2312,
-        OutputEncoding::BIG5,
-        OutputEncoding::SHIFT_JIS
+    // 单字节编码最多扩展为3字节，GB18030四字节序列对应4字节，按输入长度的3倍预留通常无需扩容
+    const size_t reserve = input.size() * 3 + 16;
+    if (iconv_output_.size() < reserve) iconv_output_.resize(reserve);
+
+    char* in = const_cast<char*>(input.data());
+    size_t in_left = input.size();
+    char* out = iconv_output_.data();
+    size_t out_left = iconv_output_.size();
+
+    auto grow = [&]() {
+        const size_t used = iconv_output_.size() - out_left;
+        iconv_output_.resize(iconv_output_.size() * 2);
+        out = iconv_output_.data() + used;
+        out_left = iconv_output_.size() - used;
     };
 
-    for (OutputEncoding encoding : encodingsToTry) {
-        std::string converted = ConvertToUTF8(input, encoding);
-        if (converted != input && IsValidUTF8(converted)) {
-            // 转换成功且结果是有效的UTF-8
-            return converted;
+    while (in_left > 0) {
+        if (iconv(cd, &in, &in_left, &out, &out_left) != static_cast<size_t>(-1)) break;
+        if (errno == E2BIG) {
+            grow();
+            continue;
         }
+        // EILSEQ/EINVAL：无法转换或不完整的字节替换为U+FFFD后跳过
+        if (out_left < 3) grow();
+        memcpy(out, "\xEF\xBF\xBD", 3);
+        out += 3;
+        out_left -= 3;
+        ++in;
+        --in_left;
     }
 
-    // 如果所有编码都失败，尝试使用系统默认代码页
-    return ConvertToUTF8(input, OutputEncoding::GBK); // 默认使用GBK
+    return {iconv_output_.data(), iconv_output_.size() - out_left};
 }
+
+// 新的输出流开始时清除各描述符的转换状态
+void CLIProcess::ResetUnixEncodingState() {
+    for (auto& [name, cd] : iconv_descriptors_) {
+        if (cd != reinterpret_cast<iconv_t>(-1)) {
+            iconv(cd, nullptr, nullptr, nullptr, nullptr);
+        }
+    }
+}
+#endif
+
 void CLIProcess::SetStopCommand(const std::string& command, int timeout_ms) {
     std::lock_guard<std::mutex> lock(stop_mutex_);
     stop_command_ = command;
@@ -307,10 +341,34 @@ void CLIProcess::SetStopCommand(const std::string& command, int timeout_ms) {
 }
 
 void CLIProcess::SetMaxLogLines(int max_lines) {
-    std::lock_guard<std::mutex> lock(logs_mutex_);
-    max_log_lines_ = max_lines;
-    if (logs_.size() > max_log_lines_) {
-        logs_.erase(logs_.begin(), logs_.end() - max_log_lines_);
+    auto lock = LockLogs();
+    max_log_lines_ = std::max(max_lines, 0);
+    logs_.SetLimits(static_cast<size_t>(max_log_bytes_), static_cast<size_t>(max_log_lines_));
+}
+
+void CLIProcess::SetMaxLogBytes(uint64_t max_bytes) {
+    auto lock = LockLogs();
+    max_log_bytes_ = max_bytes;
+    logs_.SetLimits(static_cast<size_t>(max_log_bytes_), static_cast<size_t>(max_log_lines_));
+}
+
+void CLIProcess::SetColdLogTier(bool enable, uint64_t max_disk_bytes) {
+    // 摘下的冷层在锁外销毁，等待写线程落盘时不阻塞读取线程和界面
+    std::unique_ptr<LogColdTier> released;
+    auto lock = LockLogs();
+    if (enable) {
+        logs_.EnableColdTier(LogColdTier::DefaultRootDir(), max_disk_bytes);
+    } else {
+        released = logs_.DisableColdTier();
+    }
+    lock.unlock();
+}
+
+void CLIProcess::SetLogFile(bool enable, const LogFileSinkConfig& config) {
+    if (enable) {
+        file_sink_.Start(config);
+    } else {
+        file_sink_.Stop();
     }
 }
 
@@ -385,17 +443,17 @@ void CLIProcess::Start(const std::string& command) {
     Stop();
 
     // 确定工作目录
-    std::wstring working_dir;
+    std::string working_dir;
     {
         std::lock_guard<std::mutex> lock(working_dir_mutex_);
         if (use_auto_working_dir_) {
-            working_dir = StringToWide(ExtractDirectoryFromCommand(command));
+            working_dir = ExtractDirectoryFromCommand(command);
             if (working_dir.empty()) {
-                working_dir = StringToWide(std::filesystem::current_path().string());
+                working_dir = std::filesystem::current_path().string();
             }
             // AddLog("自动检测工作目录: " + working_dir);
         } else {
-            working_dir = StringToWide(working_directory_);
+            working_dir = working_directory_;
             if (!working_dir.empty()) {
                 // AddLog("使用指定工作目录: " + working_dir);
             }
@@ -403,6 +461,8 @@ void CLIProcess::Start(const std::string& command) {
     }
 
 #ifdef _WIN32
+    std::wstring wide_working_dir = StringToWide(working_dir);
+
     SECURITY_ATTRIBUTES sa;
     sa.nLength = sizeof(SECURITY_ATTRIBUTES);
     sa.bInheritHandle = TRUE;
@@ -472,7 +532,7 @@ void CLIProcess::Start(const std::string& command) {
 
         // AddLog("环境变量设置完成，数量: " + std::to_string(environment_variables_.size()));
     } else {
-        // AddLog("未设置自定义环境变量，使用默认环境 PWD:" + WideToString(working_dir));
+        // AddLog("未设置自定义环境变量，使用默认环境 PWD:" + working_dir);
     }
 
     BOOL result = CreateProcess(
@@ -483,7 +543,7 @@ void CLIProcess::Start(const std::string& command) {
             TRUE,                      // bInheritHandles
             CREATE_NO_WINDOW,          // dwCreationFlags
             nullptr,                   // lpEnvironment (使用nullptr让子进程继承当前环境)
-            working_dir.empty() ? nullptr : working_dir.data(),                   // lpCurrentDirectory
+            working_dir.empty() ? nullptr : wide_working_dir.data(),              // lpCurrentDirectory
             &si,                       // lpStartupInfo
             &pi_                       // lpProcessInformation
     );
@@ -539,17 +599,32 @@ void CLIProcess::Start(const std::string& command) {
     }
 #else
     // Unix/Linux implementation
-    int pipe_out[2];
-    int pipe_in[2];
+    int pipe_out[2] = {-1, -1};
+    int pipe_in[2] = {-1, -1};
+    int pipe_stop[2] = {-1, -1};
+    auto close_all = [&]() {
+        for (int fd : {pipe_out[0], pipe_out[1], pipe_in[0], pipe_in[1], pipe_stop[0], pipe_stop[1]}) {
+            if (fd >= 0) close(fd);
+        }
+    };
 
-    if (pipe(pipe_out) < 0 || pipe(pipe_in) < 0) {
+    if (pipe(pipe_out) < 0 || pipe(pipe_in) < 0 || pipe(pipe_stop) < 0) {
         AddLog("创建管道失败: " + std::string(strerror(errno)));
+        close_all();
         return;
     }
+    // 全部标记FD_CLOEXEC：子进程中dup2到标准流的副本不受影响，其余描述符不会泄漏给exec出的程序
+    for (int fd : {pipe_out[0], pipe_out[1], pipe_in[0], pipe_in[1], pipe_stop[0], pipe_stop[1]}) {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    // 读取端非阻塞，Stop()唤醒读取线程后可以排空管道而不被仍持有写端的进程卡住
+    fcntl(pipe_out[0], F_SETFL, fcntl(pipe_out[0], F_GETFL) | O_NONBLOCK);
 
     pid_t pid = fork();
     if (pid == 0) {
         // child process
+        // 自成进程组，Stop()可以连同sh -c启动的后台进程一起终止
+        setpgid(0, 0);
         close(pipe_out[0]);
         dup2(pipe_out[1], STDOUT_FILENO);
         dup2(pipe_out[1], STDERR_FILENO);
@@ -587,14 +662,18 @@ void CLIProcess::Start(const std::string& command) {
     }
     else if (pid > 0) {
         // parent process
+        // 父进程也设置一次，避免Stop()在子进程执行setpgid之前到来
+        setpgid(pid, pid);
         close(pipe_out[1]);
         close(pipe_in[0]);
 
         process_pid_ = pid;
         pipe_stdout_[0] = pipe_out[0];
-        pipe_stdout_[1] = pipe_out[1]; // closed already in parent, but keep for safety
-        pipe_stdin_[0] = pipe_in[0];   // closed already in parent, but keep for safety
+        pipe_stdout_[1] = -1;
+        pipe_stdin_[0] = -1;
         pipe_stdin_[1] = pipe_in[1];
+        stop_pipe_[0] = pipe_stop[0];
+        stop_pipe_[1] = pipe_stop[1];
 
         process_running_ = true;
 
@@ -607,10 +686,7 @@ void CLIProcess::Start(const std::string& command) {
         output_thread_ = std::thread(&CLIProcess::ReadOutput, this);
     } else {
         AddLog("fork失败，无法启动进程: " + std::string(strerror(errno)));
-        close(pipe_out[0]);
-        close(pipe_out[1]);
-        close(pipe_in[0]);
-        close(pipe_in[1]);
+        close_all();
     }
 #endif
 }
@@ -629,9 +705,9 @@ void CLIProcess::Stop() {
         CloseProcessHandles();
     }
 #else
-    if (process_running_) {
-        std::lock_guard<std::mutex> lock(stop_mutex_);
-        if (!stop_command_.empty()) {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    if (process_pid_ > 0) {
+        if (process_running_ && !stop_command_.empty()) {
             SendCommand(stop_command_);
             // Wait for termination or timeout
             int status = 0;
@@ -644,22 +720,57 @@ void CLIProcess::Stop() {
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
         }
-        if (process_running_) {
-            kill(process_pid_, SIGKILL);
-            waitpid(process_pid_, nullptr, 0);
-            process_running_ = false;
-        }
-        CloseProcessHandles();
+        // sh本身可能已经退出(IsRunning()已回收)，但它启动的进程仍在组内并持有输出管道
+        TerminateProcessGroup();
+    }
+    // 进程组已终止；逃出进程组的后代(setsid等)可能仍持有写端，唤醒读取线程排空管道后退出
+    if (stop_pipe_[1] >= 0) {
+        const char wake = 1;
+        while (write(stop_pipe_[1], &wake, 1) < 0 && errno == EINTR) {}
     }
 #endif
 
     if (output_thread_.joinable()) {
         output_thread_.join();
     }
+#ifndef _WIN32
+    // 读取线程退出之后再关闭管道
+    CloseProcessHandles();
+#endif
+}
+
+#ifndef _WIN32
+// 先SIGTERM整个进程组，宽限期内未退出再SIGKILL；顺带回收sh
+void CLIProcess::TerminateProcessGroup() {
+    const pid_t group = process_pid_;
+    auto reap = [this]() {
+        if (process_running_ && waitpid(process_pid_, nullptr, WNOHANG) != 0) {
+            process_running_ = false;
+        }
+    };
+
+    if (kill(-group, SIGTERM) == 0) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kTermGraceMs);
+        while (std::chrono::steady_clock::now() < deadline) {
+            reap();
+            // 组内已没有进程(僵尸状态的sh也算组成员，所以要先回收)
+            if (kill(-group, 0) != 0) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        kill(-group, SIGKILL);
+    }
+    if (process_running_) {
+        kill(process_pid_, SIGKILL);
+        waitpid(process_pid_, nullptr, 0);
+        process_running_ = false;
+    }
+    process_pid_ = -1;
 }
+#endif
 
 // 关闭进程句柄的辅助函数
 void CLIProcess::CloseProcessHandles() {
+#ifdef _WIN32
     if (pi_.hProcess) {
         CloseHandle(pi_.hProcess);
         pi_.hProcess = nullptr;
@@ -668,10 +779,19 @@ void CLIProcess::CloseProcessHandles() {
         CloseHandle(pi_.hThread);
         pi_.hThread = nullptr;
     }
+#else
+    for (int* fd : {&pipe_stdout_[0], &pipe_stdin_[1], &stop_pipe_[0], &stop_pipe_[1]}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+#endif
 }
 
 // 清理资源的辅助函数
 void CLIProcess::CleanupResources() {
+#ifdef _WIN32
     // 关闭输入管道写入端（通知进程停止）
     if (hWritePipe_stdin_) {
         CloseHandle(hWritePipe_stdin_);
@@ -699,6 +819,12 @@ void CLIProcess::CleanupResources() {
         CloseHandle(hReadPipe_stdin_);
         hReadPipe_stdin_ = nullptr;
     }
+#else
+    if (output_thread_.joinable()) {
+        output_thread_.join();
+    }
+    CloseProcessHandles();
+#endif
 }
 
 void CLIProcess::Restart(const std::string& command) {
@@ -707,21 +833,88 @@ void CLIProcess::Restart(const std::string& command) {
 }
 
 void CLIProcess::ClearLogs() {
-    std::lock_guard<std::mutex> lock(logs_mutex_);
-    logs_.clear();
+    auto lock = LockLogs();
+    ingest_queue_.PopBatch([](std::string&&) {});
+    logs_.Clear();
 }
 
 void CLIProcess::AddLog(const std::string& log) {
-    std::lock_guard<std::mutex> lock(logs_mutex_);
-    logs_.push_back(log);
-    if (logs_.size() > max_log_lines_) {
-        logs_.erase(logs_.begin(), logs_.begin() + (logs_.size() - max_log_lines_));
+    auto lock = LockLogs();
+    logs_.Push(log);
+}
+
+// 返回的快照可在锁外使用，读取期间的追加和淘汰不会影响它
+LogSnapshotPtr CLIProcess::GetLogSnapshot() const {
+    auto lock = LockLogs();
+    return logs_.Snapshot();
+}
+
+void CLIProcess::SetSearchIndexEnabled(bool enable) {
+    auto lock = LockLogs();
+    logs_.SetSearchIndexEnabled(enable);
+}
+
+std::vector<uint64_t> CLIProcess::SearchLogs(const std::string& query, size_t max_results, uint64_t from_id,
+                                             uint64_t& searched_end) const {
+    auto lock = LockLogs();
+    searched_end = logs_.EndId();
+    return logs_.Search(query, max_results, from_id);
+}
+
+size_t CLIProcess::GetSearchIndexBytes() const {
+    auto lock = LockLogs();
+    return logs_.SearchIndexBytes();
+}
+
+// 仅由读取线程调用，不触碰logs_mutex_；队列满时丢弃并计数，绝不阻塞读取管道(文件输出只做内存拷贝)
+void CLIProcess::PushOutputLine(std::string&& line) {
+    PerfCounters::Global().read_lines.fetch_add(1, std::memory_order_relaxed);
+    file_sink_.Append(line);
+    if (!ingest_queue_.TryPush(std::move(line))) {
+        ingest_dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 界面取走队列之前只唤醒一次，突发输出不会淹没界面线程的消息队列
+    if (ingest_wake_ && !ingest_wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        ingest_wake_();
     }
 }
 
-const std::vector<std::string>& CLIProcess::GetLogs() const {
-    std::lock_guard<std::mutex> lock(logs_mutex_);
-    return logs_;
+// 加日志锁并累计等待时间：无竞争时只有一次try_lock，不读时钟
+std::unique_lock<std::mutex> CLIProcess::LockLogs() const {
+    std::unique_lock<std::mutex> lock(logs_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        PerfTimer timer(PerfCounters::Global().logs_lock_wait_ns);
+        lock.lock();
+    }
+    return lock;
+}
+
+// 由UI线程每帧调用一次：一次加锁批量并入日志
+size_t CLIProcess::DrainIngestQueue() {
+    // 先清除唤醒标记再取队列，取走之后到达的行会再次唤醒
+    ingest_wake_pending_.store(false, std::memory_order_release);
+    auto lock = LockLogs();
+    size_t drained = ingest_queue_.PopBatch([this](std::string&& line) {
+        logs_.Push(line);
+    });
+
+    uint64_t dropped = ingest_dropped_.load(std::memory_order_relaxed);
+    if (dropped != ingest_dropped_reported_) {
+        logs_.Push("警告: 日志接收队列已满，丢弃了 " +
+                   std::to_string(dropped - ingest_dropped_reported_) + " 行输出");
+        ingest_dropped_reported_ = dropped;
+    }
+
+    logs_.MaintainColdTier();
+    return drained;
+}
+
+CLIProcess::IngestStats CLIProcess::GetIngestStats() const {
+    return {
+        ingest_queue_.SizeApprox(),
+        ingest_queue_.Capacity(),
+        ingest_dropped_.load(std::memory_order_relaxed)
+    };
 }
 
 
@@ -752,14 +945,21 @@ bool CLIProcess::SendCommand(const std::string &command) {
 
 void CLIProcess::CopyLogsToClipboard() const {
 #ifdef _WIN32
-    std::lock_guard<std::mutex> lock(logs_mutex_);
-    if (logs_.empty()) return;
+    const auto logs = GetLogSnapshot();
+    if (logs->Empty()) return;
 
-    // 构建完整的日志字符串（使用\r\n确保跨平台兼容）
+    // 构建完整的日志字符串，按显式长度逐行转换，不依赖NUL结尾
     std::wstring allLogs;
-    for (const auto& log : logs_) {
-        allLogs += StringToWide(log) ;
-        allLogs.resize(allLogs.size() - sizeof(wchar_t));
+    for (size_t i = 0; i < logs->Size(); ++i) {
+        const std::string_view line = (*logs)[i];
+        if (!line.empty()) {
+            const int wideSize = MultiByteToWideChar(CP_UTF8, 0, line.data(), static_cast<int>(line.size()), nullptr, 0);
+            if (wideSize > 0) {
+                const size_t oldSize = allLogs.size();
+                allLogs.resize(oldSize + wideSize);
+                MultiByteToWideChar(CP_UTF8, 0, line.data(), static_cast<int>(line.size()), &allLogs[oldSize], wideSize);
+            }
+        }
         allLogs += L"\n";
     }
 
@@ -786,11 +986,10 @@ void CLIProcess::CopyLogsToClipboard() const {
 #else
     // Unix / macOS, use xclip or pbcopy
     std::string clipboard_text;
-    {
-        std::lock_guard<std::mutex> lock(logs_mutex_);
-        for (const auto& line : logs_) {
-            clipboard_text += line + "\n";
-        }
+    const auto logs = GetLogSnapshot();
+    for (size_t i = 0; i < logs->Size(); ++i) {
+        clipboard_text.append((*logs)[i]);
+        clipboard_text += '\n';
     }
     FILE* pipe = popen("pbcopy", "w");
     if (!pipe) {
@@ -822,81 +1021,105 @@ bool CLIProcess::IsRunning() const {
 
 
 void CLIProcess::ReadOutput() {
-#ifdef _WIN32
-    constexpr int BUFFER_SIZE = 4096;
+    constexpr size_t BUFFER_SIZE = 4096;
     char buffer[BUFFER_SIZE];
-    DWORD bytesRead;
-    std::string partialLine;
-
-    while (true) {
-        if (!ReadFile(hReadPipe_, buffer, BUFFER_SIZE - 1, &bytesRead, nullptr) || bytesRead == 0) {
-            break;
+    StreamDecoder decoder;
+    LineFramer framer;
+    std::string transcode_buffer;   // 转换输出，跨读取复用
+#ifdef _WIN32
+    std::wstring wide_buffer;       // 系统接口转换的UTF-16中间结果
+#endif
+    auto push_line = [this](std::string&& line) { PushOutputLine(std::move(line)); };
+    PerfCounters& perf = PerfCounters::Global();
+
+    // 解码器只交出以完整字符结尾的字节，跨两次读取的多字节字符会被拼接后再转换
+    auto feed = [&](const StreamDecoder::Piece& piece) {
+        if (piece.bytes.empty()) return;
+        std::string_view utf8 = piece.bytes;
+        if (piece.encoding != OutputEncoding::UTF8) {
+            PerfTimer timer(perf.conversion_ns);
+            if (CanTranscodeToUtf8(piece.encoding)) {
+                utf8 = TranscodeToUtf8(piece.bytes, piece.encoding, transcode_buffer);
+            } else {
+                // 内置转换表未覆盖的编码(GB2312代码页、EUC-JP)交给系统接口
+#ifdef _WIN32
+                utf8 = ConvertToUTF8(piece.bytes, piece.encoding, wide_buffer, transcode_buffer);
+#else
+                utf8 = ConvertUnixEncoding(piece.bytes, GetUnixEncodingName(piece.encoding));
+#endif
+            }
         }
+        framer.Feed(utf8, push_line);
+    };
 
-        buffer[bytesRead] = '\0';
-        std::string output(buffer);
-
-        // 根据设置的编码转换输出
-        OutputEncoding currentEncoding;
+    auto take = [&](std::string_view chunk) {
+        OutputEncoding requested;
         {
             std::lock_guard<std::mutex> lock(encoding_mutex_);
-            currentEncoding = output_encoding_;
+            requested = output_encoding_;
         }
-
-        std::string convertedOutput;
-        if (currentEncoding == OutputEncoding::AUTO_DETECT) {
-            convertedOutput = DetectAndConvertToUTF8(output);
-        } else {
-            convertedOutput = ConvertToUTF8(output, currentEncoding);
+        perf.read_bytes.fetch_add(chunk.size(), std::memory_order_relaxed);
+        const StreamDecoder::Piece piece = [&] {
+            PerfTimer timer(perf.conversion_ns);
+            return decoder.Take(chunk, requested);
+        }();
+        feed(piece);
+        if (requested == OutputEncoding::AUTO_DETECT) {
+            std::lock_guard<std::mutex> lock(encoding_mutex_);
+            detected_encoding_ = decoder.Detection();
         }
+    };
 
-        size_t start = 0;
-        size_t end = convertedOutput.find('\n');
-
-        while (end != std::string::npos) {
-            std::string line = partialLine + convertedOutput.substr(start, end - start);
-            partialLine.clear();
-
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-
-            if (!line.empty()) {
-                AddLog(line);
-            }
+#ifdef _WIN32
+    DWORD bytesRead;
 
-            start = end + 1;
-            end = convertedOutput.find('\n', start);
+    while (true) {
+        if (!ReadFile(hReadPipe_, buffer, BUFFER_SIZE, &bytesRead, nullptr) || bytesRead == 0) {
+            break;
         }
 
-        if (start < convertedOutput.size()) {
-            partialLine = convertedOutput.substr(start);
-        }
+        take(std::string_view(buffer, bytesRead));
     }
 #else
-const int buffer_size = 4096;
-char buffer[buffer_size];
-ssize_t bytes_read = 0;
-while (process_running_) {
-    bytes_read = read(pipe_stdout_[0], buffer, buffer_size - 1);
-    if (bytes_read <= 0) break;
-    buffer[bytes_read] = '\0';
-
-    std::string utf8_str;
-    {
-        std::lock_guard<std::mutex> lock(encoding_mutex_);
-        if (output_encoding_ == OutputEncoding::AUTO_DETECT) {
-            utf8_str = DetectAndConvertToUTF8(std::string(buffer));
-        } else {
-            utf8_str = ConvertToUTF8(std::string(buffer), output_encoding_);
+    ResetUnixEncodingState();
+
+    // 读到EOF为止：子进程退出后管道中剩余的输出也要读完。
+    // 同时等待自管道：后台进程仍持有写端时不会有EOF，Stop()通过它让读取线程排空管道后退出
+    pollfd fds[2] = {{pipe_stdout_[0], POLLIN, 0}, {stop_pipe_[0], POLLIN, 0}};
+    bool stopping = false;
+    int drain_reads = 256;  // 停止后最多再读这么多次，防止写端持续输出时无法退出
+    while (true) {
+        if (stopping && --drain_reads < 0) break;
+        if (!stopping) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            stopping = (fds[1].revents & POLLIN) != 0;
+            if (!stopping && fds[0].revents == 0) continue;
         }
+
+        const ssize_t bytes_read = read(pipe_stdout_[0], buffer, BUFFER_SIZE);
+        if (bytes_read < 0 && errno == EINTR) continue;
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && !stopping) continue;
+        if (bytes_read <= 0) break;
+
+        // 按实际读取长度处理，输出中的NUL字节不会截断内容
+        take(std::string_view(buffer, static_cast<size_t>(bytes_read)));
     }
-    AddLog(utf8_str);
-}
 #endif
+
+    // 进程退出时可能残留不完整的字符，最后一行也可能没有换行符
+    feed(decoder.Flush());
+    framer.Flush(push_line);
 }
 
 std::wstring CLIProcess::GetPid() const {
+#ifdef _WIN32
     if (pi_.hProcess == nullptr) return L"";
     return StringToWide(std::to_string(pi_.dwProcessId));
+#else
+    if (!process_running_) return L"";
+    return StringToWide(std::to_string(process_pid_));
+#endif
 }
@@ -0,0 +1,254 @@
+#include "EncodingDetector.h"
+#include "Utf8.h"
+
+namespace {
+    constexpr uint8_t kSingle = 4;      // 合法的单字节非ASCII字符(如半角片假名)
+    constexpr uint8_t kBad = 0xFF;      // 不能出现在字符开头的字节
+
+    // 候选编码的字节语法，全部查表
+    struct Grammar {
+        uint8_t lead[256];          // 0:ASCII 1~3:后续字节数 kSingle kBad
+        uint8_t trail[256];         // 位k-1表示可作为第k个后续字节
+        uint8_t four_byte[256];     // 非0表示该第二字节把双字节序列变为四字节(GB18030)
+        uint8_t common_min[256];    // 首字节 -> 高频区内第二字节的范围，min>max表示不在高频区
+        uint8_t common_max[256];
+        bool multi_is_common;       // 3/4字节字符是否计为高频(UTF-8)
+    };
+
+    constexpr void SetRange(uint8_t* table, unsigned lo, unsigned hi, uint8_t value) {
+        for (unsigned b = lo; b <= hi; ++b) table[b] = value;
+    }
+
+    constexpr void OrRange(uint8_t* table, unsigned lo, unsigned hi, uint8_t bits) {
+        for (unsigned b = lo; b <= hi; ++b) table[b] |= bits;
+    }
+
+    constexpr void SetCommon(Grammar& g, unsigned lead_lo, unsigned lead_hi, unsigned trail_lo, unsigned trail_hi) {
+        for (unsigned b = lead_lo; b <= lead_hi; ++b) {
+            g.common_min[b] = static_cast<uint8_t>(trail_lo);
+            g.common_max[b] = static_cast<uint8_t>(trail_hi);
+        }
+    }
+
+    constexpr Grammar MakeGrammar(OutputEncoding encoding) {
+        Grammar g{};
+        SetRange(g.lead, 0x80, 0xFF, kBad);
+        SetRange(g.common_min, 0x00, 0xFF, 0xFF);
+        g.multi_is_common = false;
+
+        switch (encoding) {
+            case OutputEncoding::UTF8:
+                SetRange(g.lead, 0xC2, 0xDF, 1);
+                SetRange(g.lead, 0xE0, 0xEF, 2);
+                SetRange(g.lead, 0xF0, 0xF4, 3);
+                OrRange(g.trail, 0x80, 0xBF, 0x7);
+                // 能通过语法检查的UTF-8多字节字符本身就是强证据
+                SetCommon(g, 0xC2, 0xDF, 0x80, 0xBF);
+                g.multi_is_common = true;
+                break;
+#ifdef _WIN32
+            case OutputEncoding::GBK:
+#else
+            case OutputEncoding::GB18030:
+                // 四字节序列：首字节 0x30-0x39 0x81-0xFE 0x30-0x39(生僻字)
+                SetRange(g.four_byte, 0x30, 0x39, 1);
+                OrRange(g.trail, 0x30, 0x39, 0x4);
+                OrRange(g.trail, 0x81, 0xFE, 0x2);
+#endif
+                SetRange(g.lead, 0x81, 0xFE, 1);
+                OrRange(g.trail, 0x40, 0x7E, 0x1);
+                OrRange(g.trail, 0x80, 0xFE, 0x1);
+                // GB2312一级汉字(按使用频率选出)和全角标点
+                SetCommon(g, 0xB0, 0xD7, 0xA1, 0xFE);
+                SetCommon(g, 0xA1, 0xA3, 0xA1, 0xFE);
+                break;
+            case OutputEncoding::BIG5:
+                SetRange(g.lead, 0x81, 0xFE, 1);
+                OrRange(g.trail, 0x40, 0x7E, 0x1);
+                OrRange(g.trail, 0xA1, 0xFE, 0x1);
+                // 常用字A440-C67E和标点
+                SetCommon(g, 0xA4, 0xC5, 0x40, 0xFE);
+                SetCommon(g, 0xC6, 0xC6, 0x40, 0x7E);
+                SetCommon(g, 0xA1, 0xA3, 0x40, 0xFE);
+                break;
+#ifdef _WIN32
+            case OutputEncoding::SHIFT_JIS:
+                SetRange(g.lead, 0xA1, 0xDF, kSingle);
+                SetRange(g.lead, 0x81, 0x9F, 1);
+                SetRange(g.lead, 0xE0, 0xFC, 1);
+                OrRange(g.trail, 0x40, 0x7E, 0x1);
+                OrRange(g.trail, 0x80, 0xFC, 0x1);
+                // 标点、平假名、片假名、第一水准汉字
+                SetCommon(g, 0x81, 0x81, 0x40, 0xFC);
+                SetCommon(g, 0x82, 0x82, 0x9F, 0xF1);
+                SetCommon(g, 0x83, 0x83, 0x40, 0x96);
+                SetCommon(g, 0x88, 0x98, 0x40, 0xFC);
+                break;
+#else
+            case OutputEncoding::EUC_JP:
+                SetRange(g.lead, 0x8E, 0x8E, 1);    // 半角片假名
+                SetRange(g.lead, 0x8F, 0x8F, 2);    // JIS X 0212
+                SetRange(g.lead, 0xA1, 0xFE, 1);
+                OrRange(g.trail, 0xA1, 0xFE, 0x3);
+                // 标点、平假名、片假名、第一水准汉字
+                SetCommon(g, 0xA1, 0xA1, 0xA1, 0xFE);
+                SetCommon(g, 0xA4, 0xA5, 0xA1, 0xFE);
+                SetCommon(g, 0xB0, 0xCF, 0xA1, 0xFE);
+                break;
+#endif
+            default:
+                break;
+        }
+        return g;
+    }
+
+    // 单个候选编码的切分状态
+    struct Scanner {
+        const Grammar* grammar;
+        uint8_t lead = 0;
+        uint8_t second = 0;
+        uint8_t have = 0;   // 已读到的后续字节数
+        uint8_t need = 0;   // 还需要的后续字节总数，0表示处于字符边界
+
+        enum Step { Continue, Char, Common, Error };
+
+        // 消费一个非ASCII字节或序列中的字节；序列中途出错时当前字节会重新作为新字符的开头处理，
+        // 因此一次调用最多产生一个错误和一个字符
+        Step Feed(unsigned char b, bool& error) {
+            const Grammar& g = *grammar;
+            if (need != 0) {
+                bool valid = (g.trail[b] & (1u << have)) != 0;
+                if (have == 0 && g.four_byte[b]) {
+                    need = 3;
+                    valid = true;
+                }
+                if (valid) {
+                    if (have == 0) second = b;
+                    if (++have < need) return Continue;
+                    const bool pair = need == 1;
+                    need = 0;
+                    if (!pair) return g.multi_is_common ? Common : Char;
+                    return (second >= g.common_min[lead] && second <= g.common_max[lead]) ? Common : Char;
+                }
+                error = true;
+                need = 0;
+            }
+
+            const uint8_t kind = g.lead[b];
+            if (kind == 0) return Continue;
+            if (kind == kSingle) return Char;
+            if (kind == kBad) return Error;
+            lead = b;
+            have = 0;
+            need = kind;
+            return Continue;
+        }
+    };
+
+#ifdef _WIN32
+    constexpr Grammar kGrammars[] = {
+        MakeGrammar(OutputEncoding::UTF8), MakeGrammar(OutputEncoding::GBK),
+        MakeGrammar(OutputEncoding::BIG5), MakeGrammar(OutputEncoding::SHIFT_JIS)};
+#else
+    constexpr Grammar kGrammars[] = {
+        MakeGrammar(OutputEncoding::UTF8), MakeGrammar(OutputEncoding::GB18030),
+        MakeGrammar(OutputEncoding::BIG5), MakeGrammar(OutputEncoding::EUC_JP)};
+#endif
+}
+
+float EncodingDetector::Score::Confidence() const {
+    if (chars == 0) return 0.0f;
+    const float weighted = static_cast<float>(common) + 0.25f * static_cast<float>(chars - common);
+    return weighted / (static_cast<float>(chars) + 4.0f * static_cast<float>(errors));
+}
+
+// 所有候选编码在同一次遍历中推进；各状态机都处于字符边界时ASCII字节直接跳过
+void EncodingDetector::Accumulate(std::string_view data, std::array<Score, kCandidates.size()>& scores) {
+    static_assert(std::size(kGrammars) == kCandidates.size());
+    std::array<Scanner, kCandidates.size()> scanners{};
+    for (size_t i = 0; i < kCandidates.size(); ++i) scanners[i].grammar = &kGrammars[i];
+
+    bool busy = false;
+    for (const char c : data) {
+        const auto b = static_cast<unsigned char>(c);
+        if (!busy && b < 0x80) continue;
+
+        busy = false;
+        for (size_t i = 0; i < kCandidates.size(); ++i) {
+            bool error = false;
+            switch (scanners[i].Feed(b, error)) {
+                case Scanner::Error: error = true; break;
+                case Scanner::Char: ++scores[i].chars; break;
+                case Scanner::Common: ++scores[i].chars; ++scores[i].common; break;
+                case Scanner::Continue: break;
+            }
+            scores[i].errors += error;
+            busy |= scanners[i].need != 0;
+        }
+    }
+    // 块尾未完成的序列由流式解码器留到下一块，不计为错误
+}
+
+uint32_t EncodingDetector::CountErrors(std::string_view data, OutputEncoding encoding) {
+    if (encoding == OutputEncoding::UTF8) {
+        return IsValidUTF8(data.substr(0, data.size() - Utf8IncompleteTail(data))) ? 0 : 1;
+    }
+
+    Scanner scanner;
+    scanner.grammar = &kGrammars[0];
+    for (size_t i = 0; i < kCandidates.size(); ++i) {
+        if (kCandidates[i] == encoding) scanner.grammar = &kGrammars[i];
+    }
+
+    uint32_t errors = 0;
+    for (const char c : data) {
+        const auto b = static_cast<unsigned char>(c);
+        if (scanner.need == 0 && b < 0x80) continue;
+        bool error = false;
+        if (scanner.Feed(b, error) == Scanner::Error) error = true;
+        errors += error;
+    }
+    return errors;
+}
+
+void EncodingDetector::Evaluate() {
+    size_t best = kCandidates.size();
+    float best_confidence = 0.0f;
+    float second_confidence = 0.0f;
+    for (size_t i = 0; i < kCandidates.size(); ++i) {
+        const float confidence = scores_[i].Confidence();
+        if (best == kCandidates.size() || confidence > best_confidence) {
+            second_confidence = best_confidence;
+            best_confidence = confidence;
+            best = i;
+        } else if (confidence > second_confidence) {
+            second_confidence = confidence;
+        }
+    }
+
+    // 还没有多字节证据(纯ASCII)时沿用当前编码
+    if (scores_[best].chars == 0) return;
+
+    current_ = kCandidates[best];
+    confidence_ = best_confidence;
+    locked_ = scores_[best].chars >= kMinLockChars &&
+              best_confidence >= kMinLockConfidence &&
+              best_confidence - second_confidence >= kMinLockMargin;
+}
+
+OutputEncoding EncodingDetector::Resolve(std::string_view data) {
+    if (locked_) {
+        if (CountErrors(data, current_) == 0) return current_;
+        // 锁定的编码出现解码错误：丢弃累计的统计，从这一块开始重新评估
+        locked_ = false;
+        scores_ = {};
+    }
+
+    Accumulate(data, scores_);
+    Evaluate();
+    return current_;
+}
+
+void EncodingDetector::Reset() {
+    *this = EncodingDetector();
+}
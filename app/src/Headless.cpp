@@ -0,0 +1,163 @@
+#include "Headless.h"
+#include "AppState.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+    // 无界面时内存中的日志没有读者，只保留少量最近的行
+    constexpr uint64_t kHeadlessLogBytes = 4ull << 20;
+    constexpr auto kPollInterval = std::chrono::milliseconds(200);
+    constexpr auto kMinRestartDelay = std::chrono::seconds(1);
+    constexpr auto kMaxRestartDelay = std::chrono::seconds(60);
+    // 运行超过该时长后退出视为偶发，重启间隔回到最小值
+    constexpr auto kStableRunTime = std::chrono::seconds(60);
+
+    std::atomic<bool> g_stop_requested{false};
+
+    // 读取线程有新输出时唤醒看护循环，及时取走接收队列
+    std::mutex g_wake_mutex;
+    std::condition_variable g_wake;
+    bool g_wake_pending = false;
+
+    void Wake() {
+        {
+            std::lock_guard<std::mutex> lock(g_wake_mutex);
+            g_wake_pending = true;
+        }
+        g_wake.notify_one();
+    }
+
+#ifdef _WIN32
+    // 看护循环停止子进程并写完日志文件后置位
+    HANDLE g_stopped = nullptr;
+
+    // 关闭控制台、注销和关机时处理函数一返回系统就结束进程，因此要在这里等看护循环收尾；
+    // 系统给的时间有限(关闭控制台约5秒)，超时仍会被结束
+    BOOL WINAPI ConsoleCtrlHandler(DWORD type) {
+        g_stop_requested.store(true);
+        Wake();
+        if (type == CTRL_CLOSE_EVENT || type == CTRL_LOGOFF_EVENT || type == CTRL_SHUTDOWN_EVENT) {
+            WaitForSingleObject(g_stopped, INFINITE);
+        }
+        return TRUE;
+    }
+
+    // GUI子系统程序(CLI_Manager --headless)没有自己的控制台，从命令行启动时挂到父进程的控制台上输出状态；
+    // climanager_headless是控制台程序，已有控制台时AttachConsole失败，不影响输出
+    void AttachParentConsole() {
+        g_stopped = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+            FILE* stream = nullptr;
+            freopen_s(&stream, "CONOUT$", "w", stderr);
+        }
+        SetConsoleCtrlHandler(ConsoleCtrlHandler, TRUE);
+    }
+
+    void SignalStopped() {
+        SetEvent(g_stopped);
+    }
+#else
+    // 信号处理函数中只设置标志，看护循环按kPollInterval轮询
+    void HandleStopSignal(int) {
+        g_stop_requested.store(true);
+    }
+
+    void SignalStopped() {}
+#endif
+
+    void Report(const char* message, const std::string& detail = {}) {
+        fprintf(stderr, "[CLI_Manager] %s%s\n", message, detail.c_str());
+        fflush(stderr);
+    }
+}
+
+bool IsHeadlessRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] && strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+int RunHeadless() {
+#ifdef _WIN32
+    AttachParentConsole();
+#else
+    signal(SIGINT, HandleStopSignal);
+    signal(SIGTERM, HandleStopSignal);
+    signal(SIGHUP, HandleStopSignal);
+#endif
+
+    AppState app_state;
+    app_state.LoadSettings();
+    const std::string command = app_state.command_input;
+    if (command.empty()) {
+        Report("未配置启动命令(climanager_settings.ini中的CommandInput)");
+        SignalStopped();
+        return 1;
+    }
+
+    // 只调整本次运行的参数，不写回设置文件；输出必须落盘，否则无处可看
+    app_state.enable_log_file = true;
+    app_state.max_log_bytes = std::min(app_state.max_log_bytes, kHeadlessLogBytes);
+    app_state.max_log_lines = 0;
+    app_state.enable_search_index = false;
+    app_state.enable_cold_log_tier = false;
+
+    CLIProcess& process = app_state.cli_process;
+    process.SetIngestWakeCallback(Wake);
+    app_state.ApplySettings();
+    app_state.ApplyLogFileSettings();
+
+    using clock = std::chrono::steady_clock;
+    auto restart_delay = std::chrono::duration_cast<clock::duration>(kMinRestartDelay);
+    clock::time_point started_at{};
+    clock::time_point restart_at = clock::now();
+    bool running = false;
+
+    // 先检查再等待，首次启动子进程不必等一个轮询周期
+    while (!g_stop_requested.load()) {
+        process.DrainIngestQueue();
+
+        const auto now = clock::now();
+        if (running && !process.IsRunning()) {
+            running = false;
+            if (now - started_at >= kStableRunTime) {
+                restart_delay = std::chrono::duration_cast<clock::duration>(kMinRestartDelay);
+            }
+            restart_at = now + restart_delay;
+            Report("子进程已退出，重启间隔(秒): ",
+                   std::to_string(std::chrono::duration_cast<std::chrono::seconds>(restart_delay).count()));
+            restart_delay = std::min(restart_delay * 2,
+                                     std::chrono::duration_cast<clock::duration>(kMaxRestartDelay));
+        }
+        if (!running && now >= restart_at) {
+            Report("启动: ", command);
+            process.Start(command);
+            started_at = now;
+            running = true;
+        }
+
+        std::unique_lock<std::mutex> lock(g_wake_mutex);
+        g_wake.wait_for(lock, kPollInterval, [] { return g_wake_pending || g_stop_requested.load(); });
+        g_wake_pending = false;
+    }
+
+    Report("正在停止子进程");
+    process.Stop();
+    process.DrainIngestQueue();
+    // 日志文件要在返回前写完：控制台关闭时进程在控制处理函数返回后立即结束，等不到析构
+    process.SetLogFile(false, {});
+    SignalStopped();
+    return 0;
+}
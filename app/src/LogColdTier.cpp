@@ -0,0 +1,340 @@
+#include "LogColdTier.h"
+#include "LogStore.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint64_t AlignUp8(uint64_t value) {
+        return (value + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    unsigned long CurrentPid() {
+#ifdef _WIN32
+        return GetCurrentProcessId();
+#else
+        return static_cast<unsigned long>(getpid());
+#endif
+    }
+
+    bool IsProcessAlive(unsigned long pid) {
+#ifdef _WIN32
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+        if (!process) return GetLastError() == ERROR_ACCESS_DENIED;
+        const bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        CloseHandle(process);
+        return alive;
+#else
+        return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+    }
+
+    // 删除已退出(崩溃或被强制结束)的会话留下的目录，仍在运行的其他实例的目录保留
+    void RemoveStaleSessionDirs(const std::filesystem::path& root_dir) {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(root_dir, ec)) {
+            const std::string name = entry.path().filename().string();
+            if (name.empty() || name.size() > 9 || name.find_first_not_of("0123456789") != std::string::npos) continue;
+            const unsigned long pid = std::stoul(name);
+            // 本进程的目录不动：重新启用冷层时，旧冷层的段可能仍被快照持有
+            if (pid != CurrentPid() && !IsProcessAlive(pid)) {
+                std::error_code remove_ec;
+                std::filesystem::remove_all(entry.path(), remove_ec);
+            }
+        }
+    }
+}
+
+LogColdSegment::~LogColdSegment() {
+    file_.Close();
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+}
+
+std::shared_ptr<LogColdSegment> LogColdSegment::Write(const std::filesystem::path& path,
+                                                      const std::vector<std::shared_ptr<const LogChunk>>& chunks) {
+    if (chunks.empty()) return nullptr;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return nullptr;
+
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> flags;
+    uint64_t data_bytes = 0;
+
+    for (const auto& chunk : chunks) {
+        for (size_t i = 0; i < chunk->line_count; ++i) {
+            // 文本与颜色段表在块中相邻，整条记录一次写出
+            const std::string_view line = chunk->Line(i);
+            const size_t record = chunk->RecordBytes(i);
+            offsets.push_back(data_bytes);
+            flags.push_back(chunk->lines[i].flags);
+            file.write(line.data(), static_cast<std::streamsize>(record));
+            data_bytes += record;
+        }
+    }
+    offsets.push_back(data_bytes);
+
+    // 偏移表按8字节对齐，映射后可直接按数组访问
+    static constexpr char kPadding[8] = {};
+    file.write(kPadding, static_cast<std::streamsize>(AlignUp8(data_bytes) - data_bytes));
+    file.write(reinterpret_cast<const char*>(offsets.data()),
+               static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+    file.write(reinterpret_cast<const char*>(flags.data()),
+               static_cast<std::streamsize>(flags.size() * sizeof(uint32_t)));
+
+    LogColdSegmentFooter footer{};
+    footer.magic = LogColdSegmentFooter::kMagic;
+    footer.version = LogColdSegmentFooter::kVersion;
+    footer.first_id = chunks.front()->first_id;
+    footer.line_count = flags.size();
+    footer.data_bytes = data_bytes;
+    file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    file.close();
+
+    if (file.fail()) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return nullptr;
+    }
+
+    std::shared_ptr<LogColdSegment> segment(new LogColdSegment());
+    segment->path_ = path;
+    if (!segment->Map(path)) {
+        return nullptr;
+    }
+    return segment;
+}
+
+bool LogColdSegment::Map(const std::filesystem::path& path) {
+    if (!file_.Open(path) || file_.Size() < sizeof(LogColdSegmentFooter)) return false;
+
+    LogColdSegmentFooter footer{};
+    memcpy(&footer, file_.Data() + file_.Size() - sizeof(footer), sizeof(footer));
+    if (footer.magic != LogColdSegmentFooter::kMagic || footer.version != LogColdSegmentFooter::kVersion) {
+        return false;
+    }
+
+    const uint64_t offsets_at = AlignUp8(footer.data_bytes);
+    const uint64_t flags_at = offsets_at + (footer.line_count + 1) * sizeof(uint64_t);
+    if (flags_at + footer.line_count * sizeof(uint32_t) + sizeof(footer) != file_.Size()) {
+        return false;
+    }
+
+    data_ = file_.Data();
+    offsets_ = reinterpret_cast<const uint64_t*>(file_.Data() + offsets_at);
+    flags_ = reinterpret_cast<const uint32_t*>(file_.Data() + flags_at);
+    first_id_ = footer.first_id;
+    line_count_ = footer.line_count;
+
+    // 写入时经过的页不必常驻
+    file_.ReleaseResident();
+    return true;
+}
+
+void LogColdSegment::TrimIfIdle() const {
+    if (touched_.exchange(false, std::memory_order_relaxed)) {
+        released_ = false;
+        return;
+    }
+    if (!released_) {
+        file_.ReleaseResident();
+        released_ = true;
+    }
+}
+
+LogColdTier::LogColdTier(const std::filesystem::path& root_dir, uint64_t max_disk_bytes)
+    : max_disk_bytes_(max_disk_bytes) {
+    dir_ = root_dir / std::to_string(CurrentPid());
+
+    RemoveStaleSessionDirs(root_dir);
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+
+    writer_thread_ = std::thread(&LogColdTier::WriterLoop, this);
+}
+
+LogColdTier::~LogColdTier() {
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        writer_stop_ = true;
+        jobs_.clear();
+    }
+    job_cv_.notify_all();
+    writer_thread_.join();
+    results_.clear();
+
+    segments_.clear();
+    pending_.clear();
+    // 仍被快照持有的段会在释放时自行删除文件，这里只清理已空的目录
+    std::error_code ec;
+    std::filesystem::remove(dir_, ec);
+}
+
+std::filesystem::path LogColdTier::DefaultRootDir() {
+    std::error_code ec;
+    const auto temp = std::filesystem::temp_directory_path(ec);
+    return ec ? std::filesystem::path("log_cache") : temp / "climanager_log_cache";
+}
+
+void LogColdTier::SetMaxDiskBytes(uint64_t max_disk_bytes) {
+    max_disk_bytes_ = max_disk_bytes;
+    EnforceDiskBudget();
+}
+
+void LogColdTier::Append(std::shared_ptr<const LogChunk> chunk) {
+    pending_bytes_ += chunk->byte_used + chunk->line_count * LogStore::kLineOverhead;
+    pending_.push_back(std::move(chunk));
+    Collect();
+    SealIfReady();
+}
+
+// 正在写的段随旧的epoch一起作废，写完后由Collect()丢弃(段对象释放时删除文件)
+void LogColdTier::Clear() {
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        jobs_.clear();
+        results_.clear();
+    }
+    ++epoch_;
+    segments_.clear();
+    pending_.clear();
+    pending_bytes_ = 0;
+    sealing_chunks_ = 0;
+    sealing_segments_ = 0;
+    disk_bytes_ = 0;
+}
+
+bool LogColdTier::Collect() {
+    if (!results_ready_.load(std::memory_order_acquire)) return false;
+
+    std::vector<SealResult> results;
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        results.swap(results_);
+        results_ready_.store(false, std::memory_order_relaxed);
+    }
+
+    bool changed = false;
+    for (auto& result : results) {
+        if (result.epoch != epoch_) continue;
+        if (result.segment) {
+            disk_bytes_ += result.segment->FileBytes();
+            segments_.push_back(std::move(result.segment));
+        } else {
+            // 写入失败时丢弃这些行以保证内存有界；更早的段一并丢弃，冷层行号始终保持连续
+            segments_.clear();
+            disk_bytes_ = 0;
+        }
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(result.chunk_count));
+        sealing_chunks_ -= result.chunk_count;
+        --sealing_segments_;
+        changed = true;
+    }
+    if (changed) {
+        EnforceDiskBudget();
+        // 写线程空出后提交此前因达到上限而留在内存中的块
+        SealIfReady();
+    }
+    return changed;
+}
+
+uint64_t LogColdTier::BeginId() const {
+    if (!segments_.empty()) return segments_.front()->FirstId();
+    return pending_.front()->first_id;
+}
+
+// 限频：最多每两秒检查一次，避免在来回滚动时反复调入调出
+void LogColdTier::TrimResident() const {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_trim_ < std::chrono::seconds(2)) return;
+    last_trim_ = now;
+
+    for (const auto& segment : segments_) {
+        segment->TrimIfIdle();
+    }
+}
+
+// 块是只读的，写线程与快照可以同时读取；段写完之前这些块仍留在pending_中
+void LogColdTier::Seal() {
+    SealJob job;
+    job.epoch = epoch_;
+    job.chunks.assign(pending_.begin() + static_cast<std::ptrdiff_t>(sealing_chunks_), pending_.end());
+    job.path = dir_ / ("seg_" + std::to_string(job.chunks.front()->first_id) + ".seg");
+    sealing_chunks_ = pending_.size();
+    ++sealing_segments_;
+    pending_bytes_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    job_cv_.notify_one();
+}
+
+// 由LogStore在持有日志锁时调用，不能等待写线程
+void LogColdTier::SealIfReady() {
+    if (pending_bytes_ < kSegmentBytes) return;
+    if (sealing_segments_ < kMaxSealingSegments) {
+        Seal();
+    } else if (pending_bytes_ > kMaxBacklogBytes) {
+        DropSealing();
+    }
+}
+
+// 丢弃已交给写线程的块及更早的段，冷层行号保持连续；攒段中的块成为冷层最旧的行。
+// 正在写的段随旧的epoch作废，写完后由Collect()丢弃
+void LogColdTier::DropSealing() {
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        jobs_.clear();
+        results_.clear();
+    }
+    ++epoch_;
+    segments_.clear();
+    disk_bytes_ = 0;
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(sealing_chunks_));
+    sealing_chunks_ = 0;
+    sealing_segments_ = 0;
+    SealIfReady();
+}
+
+void LogColdTier::WriterLoop() {
+    while (true) {
+        SealJob job;
+        {
+            std::unique_lock<std::mutex> lock(writer_mutex_);
+            job_cv_.wait(lock, [this] { return writer_stop_ || !jobs_.empty(); });
+            if (writer_stop_) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        SealResult result{job.epoch, job.chunks.size(), LogColdSegment::Write(job.path, job.chunks)};
+        job.chunks.clear();
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            results_.push_back(std::move(result));
+            results_ready_.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void LogColdTier::EnforceDiskBudget() {
+    size_t drop = 0;
+    while (drop < segments_.size() && disk_bytes_ > max_disk_bytes_) {
+        disk_bytes_ -= segments_[drop]->FileBytes();
+        ++drop;
+    }
+    if (drop > 0) {
+        segments_.erase(segments_.begin(), segments_.begin() + static_cast<std::ptrdiff_t>(drop));
+    }
+}
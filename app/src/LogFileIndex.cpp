@@ -0,0 +1,219 @@
+#include "LogFileIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <share.h>
+#endif
+
+namespace {
+    int64_t NowUnixMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    size_t CountLines(const char* begin, const char* end) {
+        size_t count = 0;
+        while (begin < end) {
+            const void* newline = memchr(begin, '\n', static_cast<size_t>(end - begin));
+            if (!newline) break;
+            ++count;
+            begin = static_cast<const char*>(newline) + 1;
+        }
+        return count;
+    }
+}
+
+std::filesystem::path LogIndexPathFor(const std::filesystem::path& log_path) {
+    std::filesystem::path index_path = log_path;
+    index_path += ".idx";
+    return index_path;
+}
+
+LogIndexWriter::~LogIndexWriter() {
+    Close();
+}
+
+bool LogIndexWriter::Open(const std::filesystem::path& log_path) {
+    Close();
+
+    const auto index_path = LogIndexPathFor(log_path);
+#ifdef _WIN32
+    // 允许历史日志查看器在写入期间读取
+    file_ = _wfsopen(index_path.c_str(), L"wb", _SH_DENYWR);
+#else
+    file_ = fopen(index_path.c_str(), "wb");
+#endif
+    if (!file_) return false;
+
+    LogIndexHeader header{LogIndexHeader::kMagic, LogIndexHeader::kVersion, kSampleLines, 0};
+    fwrite(&header, sizeof(header), 1, file_);
+
+    lines_ = 0;
+    next_sample_ = kSampleLines;
+    WriteEntry(0, 0, NowUnixMs());
+    return true;
+}
+
+void LogIndexWriter::Close() {
+    if (!file_) return;
+    fclose(file_);
+    file_ = nullptr;
+}
+
+void LogIndexWriter::Flush() {
+    if (file_) fflush(file_);
+}
+
+void LogIndexWriter::Observe(std::string_view data, uint64_t offset) {
+    if (!file_) return;
+
+    const int64_t now = NowUnixMs();
+    const char* const base = data.data();
+    const char* const end = base + data.size();
+    const char* p = base;
+    while (p < end) {
+        const void* newline = memchr(p, '\n', static_cast<size_t>(end - p));
+        if (!newline) break;
+        p = static_cast<const char*>(newline) + 1;
+        if (++lines_ == next_sample_) {
+            WriteEntry(lines_, offset + static_cast<uint64_t>(p - base), now);
+            next_sample_ += kSampleLines;
+        }
+    }
+}
+
+void LogIndexWriter::WriteEntry(uint64_t line, uint64_t offset, int64_t time_ms) {
+    const LogIndexEntry entry{line, offset, time_ms};
+    fwrite(&entry, sizeof(entry), 1, file_);
+}
+
+bool LogFileReader::Open(const std::filesystem::path& log_path) {
+    Close();
+    path_ = log_path;
+    return Refresh();
+}
+
+bool LogFileReader::Refresh() {
+    file_.Close();
+    entries_.clear();
+    line_count_ = 0;
+    cursor_line_ = 0;
+    cursor_offset_ = 0;
+
+    if (!file_.Open(path_)) return false;
+
+    if (!LoadIndex()) {
+        BuildIndex();
+    }
+
+    const LogIndexEntry& last = entries_.back();
+    line_count_ = last.line + CountLines(file_.Data() + last.offset, file_.Data() + file_.Size());
+    return true;
+}
+
+void LogFileReader::Close() {
+    file_.Close();
+    entries_.clear();
+    line_count_ = 0;
+    cursor_line_ = 0;
+    cursor_offset_ = 0;
+}
+
+// 索引可能比映射时的文件内容更新，超出文件末尾的记录丢弃
+bool LogFileReader::LoadIndex() {
+    std::ifstream in(LogIndexPathFor(path_), std::ios::binary);
+    if (!in.is_open()) return false;
+
+    LogIndexHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != LogIndexHeader::kMagic || header.version != LogIndexHeader::kVersion) {
+        return false;
+    }
+
+    LogIndexEntry entry{};
+    while (in.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+        if (entry.offset > file_.Size()) break;
+        entries_.push_back(entry);
+    }
+    return !entries_.empty();
+}
+
+// 没有旁路索引(例如外部复制来的文件)时整体扫描一次，只在内存中建立
+void LogFileReader::BuildIndex() {
+    entries_.push_back({0, 0, 0});
+
+    const char* const base = file_.Data();
+    const char* const end = base + file_.Size();
+    const char* p = base;
+    uint64_t lines = 0;
+    while (p < end) {
+        const void* newline = memchr(p, '\n', static_cast<size_t>(end - p));
+        if (!newline) break;
+        p = static_cast<const char*>(newline) + 1;
+        if (++lines % LogIndexWriter::kSampleLines == 0) {
+            entries_.push_back({lines, static_cast<uint64_t>(p - base), 0});
+        }
+    }
+}
+
+uint64_t LogFileReader::OffsetOf(uint64_t line) const {
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), line,
+                               [](uint64_t value, const LogIndexEntry& entry) { return value < entry.line; });
+    const LogIndexEntry& sample = *(it - 1);
+
+    uint64_t current_line = sample.line;
+    uint64_t offset = sample.offset;
+    if (cursor_line_ <= line && cursor_line_ > current_line) {
+        current_line = cursor_line_;
+        offset = cursor_offset_;
+    }
+
+    const char* const base = file_.Data();
+    const char* const end = base + file_.Size();
+    const char* p = base + offset;
+    while (current_line < line && p < end) {
+        const void* newline = memchr(p, '\n', static_cast<size_t>(end - p));
+        if (!newline) {
+            p = end;
+            break;
+        }
+        p = static_cast<const char*>(newline) + 1;
+        ++current_line;
+    }
+    return static_cast<uint64_t>(p - base);
+}
+
+std::string_view LogFileReader::Line(uint64_t line) const {
+    if (!file_.IsOpen() || line >= line_count_) return {};
+
+    const uint64_t offset = OffsetOf(line);
+    const char* const begin = file_.Data() + offset;
+    const char* const end = file_.Data() + file_.Size();
+    const void* newline = memchr(begin, '\n', static_cast<size_t>(end - begin));
+    const char* line_end = newline ? static_cast<const char*>(newline) : end;
+
+    cursor_line_ = line + 1;
+    cursor_offset_ = static_cast<uint64_t>(line_end - file_.Data()) + (newline ? 1 : 0);
+
+    if (line_end > begin && line_end[-1] == '\r') --line_end;
+    return {begin, static_cast<size_t>(line_end - begin)};
+}
+
+uint64_t LogFileReader::LineAtTime(int64_t time_ms) const {
+    if (entries_.empty()) return 0;
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), time_ms,
+                               [](const LogIndexEntry& entry, int64_t value) { return entry.time_ms < value; });
+    if (it == entries_.begin()) return 0;
+    return std::min((it - 1)->line, line_count_ > 0 ? line_count_ - 1 : 0);
+}
+
+int64_t LogFileReader::TimeOfLine(uint64_t line) const {
+    if (entries_.empty()) return 0;
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), line,
+                               [](uint64_t value, const LogIndexEntry& entry) { return value < entry.line; });
+    return (it - 1)->time_ms;
+}
@@ -0,0 +1,289 @@
+#include "LogFileSink.h"
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <ctime>
+#include <vector>
+
+#ifdef _WIN32
+#include <share.h>
+#endif
+
+namespace {
+    constexpr auto kFlushInterval = std::chrono::milliseconds(200);
+    constexpr const char* kFilePrefix = "output_";
+    constexpr const char* kCompressedExtension = ".lzb";
+
+    std::string TimestampForFileName() {
+        const std::time_t now = std::time(nullptr);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y%m%d_%H%M%S", &local);
+        return text;
+    }
+
+    // 索引文件随所属日志一起清理，不单独计数
+    bool IsSinkFile(const std::filesystem::path& path) {
+        const std::string name = path.filename().string();
+        return name.rfind(kFilePrefix, 0) == 0 && path.extension() != ".idx";
+    }
+}
+
+LogFileSink::~LogFileSink() {
+    Stop();
+}
+
+void LogFileSink::Start(const LogFileSinkConfig& config) {
+    // 配置未变时保持当前文件继续写，不轮转
+    if (writer_thread_.joinable() && config == config_) return;
+    Stop();
+
+    config_ = config;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        buffer_.clear();
+        buffer_.reserve(kFlushBytes * 2);
+        stop_requested_ = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(compress_mutex_);
+        compress_stop_ = false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+
+    running_.store(true, std::memory_order_release);
+    writer_thread_ = std::thread(&LogFileSink::WriterLoop, this);
+    compress_thread_ = std::thread(&LogFileSink::CompressLoop, this);
+}
+
+void LogFileSink::Stop() {
+    if (!writer_thread_.joinable()) return;
+
+    running_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        stop_requested_ = true;
+    }
+    buffer_cv_.notify_one();
+    writer_thread_.join();
+
+    // 写线程退出前已把最后一个文件送入压缩队列
+    {
+        std::lock_guard<std::mutex> lock(compress_mutex_);
+        compress_stop_ = true;
+    }
+    compress_cv_.notify_one();
+    compress_thread_.join();
+}
+
+// 任意线程可调用：只在锁内做一次内存拷贝
+void LogFileSink::Append(std::string_view line) {
+    if (!running_.load(std::memory_order_acquire)) return;
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        if (buffer_.size() + line.size() + 1 > kMaxBufferBytes) {
+            dropped_bytes_.fetch_add(line.size() + 1, std::memory_order_relaxed);
+            return;
+        }
+        buffer_.append(line.data(), line.size());
+        buffer_.push_back('\n');
+        wake = buffer_.size() >= kFlushBytes;
+    }
+    if (wake) buffer_cv_.notify_one();
+}
+
+LogFileSink::Stats LogFileSink::GetStats() const {
+    size_t buffered;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        buffered = buffer_.size();
+    }
+    return {
+        written_bytes_.load(std::memory_order_relaxed),
+        dropped_bytes_.load(std::memory_order_relaxed),
+        buffered
+    };
+}
+
+// 攒满kFlushBytes或每隔kFlushInterval交换一次缓冲区，锁外写盘
+void LogFileSink::WriterLoop() {
+    std::string batch;
+    batch.reserve(kFlushBytes * 2);
+    OpenNewFile();
+
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(buffer_mutex_);
+            buffer_cv_.wait_for(lock, kFlushInterval, [this] {
+                return stop_requested_ || buffer_.size() >= kFlushBytes;
+            });
+            batch.swap(buffer_);
+            stopping = stop_requested_;
+        }
+
+        WriteBatch(batch);
+        batch.clear();
+
+        if (file_) {
+            fflush(file_);
+            index_.Flush();
+            const bool too_old = config_.max_file_age.count() > 0 &&
+                                 std::chrono::steady_clock::now() - file_opened_ >= config_.max_file_age;
+            if (too_old && file_bytes_ > 0) {
+                CloseCurrentFile();
+                OpenNewFile();
+            }
+        }
+
+        if (stopping) break;
+    }
+
+    CloseCurrentFile();
+}
+
+// 按大小轮转时在行边界处切分，单行超过文件上限时整行写入当前文件
+void LogFileSink::WriteBatch(std::string_view data) {
+    while (!data.empty()) {
+        if (!file_) {
+            OpenNewFile();
+            if (!file_) {
+                dropped_bytes_.fetch_add(data.size(), std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        const uint64_t room = config_.max_file_bytes > file_bytes_ ? config_.max_file_bytes - file_bytes_ : 0;
+        size_t take = data.size();
+        if (take > room) {
+            const size_t cut = room > 0 ? data.rfind('\n', static_cast<size_t>(room) - 1) : std::string_view::npos;
+            if (cut != std::string_view::npos) {
+                take = cut + 1;
+            } else if (file_bytes_ > 0) {
+                CloseCurrentFile();
+                continue;
+            } else {
+                const size_t newline = data.find('\n');
+                take = newline == std::string_view::npos ? data.size() : newline + 1;
+            }
+        }
+
+        index_.Observe(data.substr(0, take), file_bytes_);
+        const size_t written = fwrite(data.data(), 1, take, file_);
+        file_bytes_ += written;
+        written_bytes_.fetch_add(written, std::memory_order_relaxed);
+        if (written != take) {
+            dropped_bytes_.fetch_add(data.size() - written, std::memory_order_relaxed);
+            CloseCurrentFile();
+            return;
+        }
+        data.remove_prefix(take);
+
+        if (file_bytes_ >= config_.max_file_bytes) {
+            CloseCurrentFile();
+        }
+    }
+}
+
+void LogFileSink::OpenNewFile() {
+    // 同一秒内轮转多次时用序号区分，文件名按字典序即时间顺序
+    char sequence[8];
+    snprintf(sequence, sizeof(sequence), "_%04u", file_sequence_++ % 10000);
+    const std::string name = kFilePrefix + TimestampForFileName() + sequence + ".log";
+    current_path_ = config_.directory / name;
+#ifdef _WIN32
+    // _wfopen_s以独占方式打开，历史日志查看器无法读取正在写入的文件；这里只拒绝其他写者
+    file_ = _wfsopen(current_path_.c_str(), L"wb", _SH_DENYWR);
+#else
+    file_ = fopen(current_path_.c_str(), "wb");
+#endif
+    if (file_) {
+        setvbuf(file_, nullptr, _IOFBF, kFlushBytes);
+        index_.Open(current_path_);
+    }
+    file_bytes_ = 0;
+    file_opened_ = std::chrono::steady_clock::now();
+    EnforceFileCount();
+}
+
+void LogFileSink::CloseCurrentFile() {
+    if (!file_) return;
+    fclose(file_);
+    file_ = nullptr;
+    index_.Close();
+
+    std::error_code ec;
+    if (file_bytes_ == 0) {
+        std::filesystem::remove(current_path_, ec);
+        std::filesystem::remove(LogIndexPathFor(current_path_), ec);
+        return;
+    }
+    if (config_.compress_closed) {
+        {
+            std::lock_guard<std::mutex> lock(compress_mutex_);
+            compress_queue_.push_back(current_path_);
+        }
+        compress_cv_.notify_one();
+    }
+}
+
+// 只清理本类生成的文件(含压缩后的)
+void LogFileSink::EnforceFileCount() {
+    if (config_.max_files == 0) return;
+
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(config_.directory, ec)) {
+        if (entry.is_regular_file(ec) && IsSinkFile(entry.path())) {
+            files.push_back(entry.path());
+        }
+    }
+    if (files.size() <= config_.max_files) return;
+
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+        return a.filename().string() < b.filename().string();
+    });
+    const size_t excess = files.size() - config_.max_files;
+    for (size_t i = 0; i < excess; ++i) {
+        if (files[i] != current_path_) {
+            std::filesystem::path log_path = files[i];
+            if (log_path.extension() == kCompressedExtension) log_path.replace_extension();
+            std::filesystem::remove(files[i], ec);
+            std::filesystem::remove(LogIndexPathFor(log_path), ec);
+        }
+    }
+}
+
+// 压缩放在独立线程，避免大文件压缩期间写线程积压
+void LogFileSink::CompressLoop() {
+    while (true) {
+        std::filesystem::path path;
+        {
+            std::unique_lock<std::mutex> lock(compress_mutex_);
+            compress_cv_.wait(lock, [this] { return compress_stop_ || !compress_queue_.empty(); });
+            if (compress_queue_.empty()) break;
+            path = std::move(compress_queue_.front());
+            compress_queue_.pop_front();
+        }
+
+        std::filesystem::path packed = path;
+        packed += kCompressedExtension;
+        std::error_code ec;
+        if (CompressFile(path, packed)) {
+            // 索引记录的是未压缩文件的偏移，对.lzb无用；查看器也只列出未压缩的日志
+            std::filesystem::remove(path, ec);
+            std::filesystem::remove(LogIndexPathFor(path), ec);
+        } else {
+            std::filesystem::remove(packed, ec);
+        }
+    }
+}
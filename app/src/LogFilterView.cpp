@@ -0,0 +1,85 @@
+#include "LogFilterView.h"
+#include "LogSearchIndex.h"
+
+#include <algorithm>
+
+LogFilterView::~LogFilterView() {
+    CancelJob();
+}
+
+void LogFilterView::CancelJob() {
+    if (!job_) return;
+    job_->cancel.store(true, std::memory_order_relaxed);
+    job_->thread.join();
+    job_.reset();
+}
+
+void LogFilterView::SetPattern(const std::string& pattern, const LogSnapshotPtr& logs) {
+    CancelJob();
+    pattern_ = pattern;
+    ids_.clear();
+    head_ = 0;
+    scanned_end_ = logs->EndId();
+    if (pattern_.empty() || logs->Empty()) return;
+
+    // 快照持有所需的块，后台线程读取期间不受写入和淘汰影响
+    job_ = std::make_unique<Job>();
+    job_->begin_id = logs->BeginId();
+    job_->end_id = logs->EndId();
+    Job* job = job_.get();
+    job_->thread = std::thread([job, logs, pattern = pattern_, wake = wake_]() {
+        for (uint64_t id = job->begin_id; id < job->end_id; ++id) {
+            if (LogSearchIndex::FindIgnoreCase(logs->ById(id), pattern) != std::string_view::npos) {
+                job->ids.push_back(id);
+            }
+            if ((id & 4095) == 0) {
+                if (job->cancel.load(std::memory_order_relaxed)) return;
+                job->scanned.store(id - job->begin_id, std::memory_order_relaxed);
+            }
+        }
+        job->done.store(true, std::memory_order_release);
+        if (wake) wake();
+    });
+}
+
+float LogFilterView::Progress() const {
+    if (!job_) return 1.0f;
+    const uint64_t total = job_->end_id - job_->begin_id;
+    return total > 0 ? static_cast<float>(job_->scanned.load(std::memory_order_relaxed)) / static_cast<float>(total) : 1.0f;
+}
+
+void LogFilterView::Update(const LogSnapshot& logs) {
+    if (pattern_.empty()) return;
+
+    if (job_) {
+        if (!job_->done.load(std::memory_order_acquire)) return;
+        job_->thread.join();
+        ids_ = std::move(job_->ids);
+        head_ = 0;
+        job_.reset();
+    }
+
+    // 丢弃已淘汰的行，前缀足够长时再整体挪动
+    while (head_ < ids_.size() && ids_[head_] < logs.BeginId()) ++head_;
+    if (head_ > 4096 && head_ * 2 > ids_.size()) {
+        ids_.erase(ids_.begin(), ids_.begin() + static_cast<std::ptrdiff_t>(head_));
+        head_ = 0;
+    }
+
+    // 每帧最多检查kMaxLinesPerFrame行，突发输出分摊到后续帧
+    scanned_end_ = std::max(scanned_end_, logs.BeginId());
+    const uint64_t end = std::min(logs.EndId(), scanned_end_ + kMaxLinesPerFrame);
+    for (uint64_t id = scanned_end_; id < end; ++id) {
+        if (LogSearchIndex::FindIgnoreCase(logs.ById(id), pattern_) != std::string_view::npos) {
+            ids_.push_back(id);
+        }
+    }
+    scanned_end_ = std::max(scanned_end_, end);
+}
+
+size_t LogFilterView::RowOf(uint64_t id) const {
+    const auto begin = ids_.begin() + static_cast<std::ptrdiff_t>(head_);
+    const auto it = std::lower_bound(begin, ids_.end(), id);
+    if (it == ids_.end() || *it != id) return SIZE_MAX;
+    return static_cast<size_t>(it - begin);
+}
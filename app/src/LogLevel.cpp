@@ -0,0 +1,120 @@
+#include "LogLevel.h"
+
+#include <array>
+#include <bit>
+#include <queue>
+#include <vector>
+
+namespace {
+    struct Keyword {
+        std::string_view text;
+        LogLevel level;
+    };
+
+    // 关键字区分大小写，与之前逐个find的匹配规则一致
+    constexpr Keyword kKeywords[] = {
+        {"错误", LogLevel::Error}, {"[E]", LogLevel::Error}, {"[ERROR]", LogLevel::Error}, {"error", LogLevel::Error},
+        {"警告", LogLevel::Warn},  {"[W]", LogLevel::Warn},  {"[WARN]", LogLevel::Warn},   {"warning", LogLevel::Warn},
+        {"信息", LogLevel::Info},  {"[I]", LogLevel::Info},  {"[INFO]", LogLevel::Info},   {"info", LogLevel::Info},
+        {"调试", LogLevel::Debug}, {"[D]", LogLevel::Debug}, {"[DEBUG]", LogLevel::Debug}, {"debug", LogLevel::Debug},
+        {"跟踪", LogLevel::Trace}, {"[T]", LogLevel::Trace}, {"[TRACE]", LogLevel::Trace}, {"trace", LogLevel::Trace},
+    };
+
+    constexpr size_t TotalKeywordBytes() {
+        size_t total = 0;
+        for (const Keyword& keyword : kKeywords) total += keyword.text.size();
+        return total;
+    }
+
+    // 关键字总长度约百字节，状态号用一个字节即可；转移表补全为DFA，扫描时不再回溯失败链
+    static_assert(TotalKeywordBytes() < 256, "状态号超出uint8_t范围");
+
+    class LevelMatcher {
+    public:
+        LevelMatcher() {
+            std::vector<std::array<int, 256>> go(1);
+            go[0].fill(-1);
+            std::vector<uint8_t> output(1, 0);
+
+            for (const Keyword& keyword : kKeywords) {
+                int state = 0;
+                for (unsigned char c : keyword.text) {
+                    if (go[state][c] < 0) {
+                        go[state][c] = static_cast<int>(go.size());
+                        go.emplace_back().fill(-1);
+                        output.push_back(0);
+                    }
+                    state = go[state][c];
+                }
+                output[state] |= static_cast<uint8_t>(1u << static_cast<unsigned>(keyword.level));
+            }
+
+            // 按层次遍历补全转移，并把失败链上的输出合并到各状态
+            std::vector<int> fail(go.size(), 0);
+            std::queue<int> pending;
+            for (int c = 0; c < 256; ++c) {
+                if (go[0][c] < 0) {
+                    go[0][c] = 0;
+                } else {
+                    pending.push(go[0][c]);
+                }
+            }
+            while (!pending.empty()) {
+                const int state = pending.front();
+                pending.pop();
+                output[state] |= output[fail[state]];
+                for (int c = 0; c < 256; ++c) {
+                    const int next = go[state][c];
+                    if (next < 0) {
+                        go[state][c] = go[fail[state]][c];
+                    } else {
+                        fail[next] = go[fail[state]][c];
+                        pending.push(next);
+                    }
+                }
+            }
+
+            transitions_.resize(go.size() * 256);
+            for (size_t state = 0; state < go.size(); ++state) {
+                for (int c = 0; c < 256; ++c) {
+                    transitions_[state * 256 + c] = static_cast<uint8_t>(go[state][c]);
+                }
+            }
+            output_ = std::move(output);
+            for (int c = 0; c < 256; ++c) {
+                starts_[c] = go[0][c] != 0;
+            }
+        }
+
+        LogLevel Classify(std::string_view text) const {
+            constexpr uint8_t kErrorBit = 1u << static_cast<unsigned>(LogLevel::Error);
+            const auto* p = reinterpret_cast<const unsigned char*>(text.data());
+            const auto* const end = p + text.size();
+            uint8_t found = 0;
+            size_t state = 0;
+            while (p < end) {
+                if (state == 0) {
+                    // 初始状态下跳过不能开始任何关键字的字节，这些比较互不依赖，比逐字节查转移表快得多
+                    while (p < end && !starts_[*p]) ++p;
+                    if (p == end) break;
+                }
+                state = transitions_[state * 256 + *p++];
+                found |= output_[state];
+                // 最高优先级已命中，不必再扫描
+                if (found & kErrorBit) break;
+            }
+            if (found == 0) return LogLevel::None;
+            return static_cast<LogLevel>(std::countr_zero(found));
+        }
+
+    private:
+        std::vector<uint8_t> transitions_;
+        std::vector<uint8_t> output_;
+        std::array<bool, 256> starts_{};
+    };
+}
+
+LogLevel ClassifyLogLevel(std::string_view text) {
+    static const LevelMatcher matcher;
+    return matcher.Classify(text);
+}
@@ -0,0 +1,173 @@
+#include "LogSearchIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    inline unsigned char FoldAscii(unsigned char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+    }
+
+    inline bool IsAsciiLetter(unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+}
+
+LogSearchIndex::LogSearchIndex()
+    : postings_(kBuckets),
+      seen_(new uint64_t[kBuckets / 64]()) {}
+
+uint32_t LogSearchIndex::Bucket(unsigned char a, unsigned char b, unsigned char c) {
+    const uint32_t key = (static_cast<uint32_t>(FoldAscii(a)) << 16) |
+                         (static_cast<uint32_t>(FoldAscii(b)) << 8) |
+                         FoldAscii(c);
+    return (key * 2654435761u) >> (32 - kBucketBits);
+}
+
+// 同一块内重复出现的三元组只登记一次，由位图过滤，避免反复访问桶
+void LogSearchIndex::Add(uint64_t id, std::string_view line) {
+    const uint64_t block = id >> kBlockShift;
+    if (block != current_block_) {
+        memset(seen_.get(), 0, kBuckets / 8);
+        current_block_ = block;
+    }
+
+    const auto* p = reinterpret_cast<const unsigned char*>(line.data());
+    for (size_t i = 0; i + 2 < line.size(); ++i) {
+        const uint32_t bucket = Bucket(p[i], p[i + 1], p[i + 2]);
+        uint64_t& word = seen_[bucket >> 6];
+        const uint64_t bit = uint64_t(1) << (bucket & 63);
+        if (word & bit) continue;
+        word |= bit;
+        postings_[bucket].push_back(static_cast<uint32_t>(block));
+    }
+}
+
+void LogSearchIndex::PruneBefore(uint64_t begin_id) {
+    const uint64_t begin_block = begin_id >> kBlockShift;
+    if (begin_block < pruned_block_ + kPruneBlocks) return;
+
+    for (auto& posting : postings_) {
+        auto it = std::lower_bound(posting.begin(), posting.end(), static_cast<uint32_t>(begin_block));
+        if (it == posting.begin()) continue;
+        posting.erase(posting.begin(), it);
+        if (posting.size() < posting.capacity() / 4) posting.shrink_to_fit();
+    }
+    pruned_block_ = begin_block;
+}
+
+void LogSearchIndex::Clear() {
+    for (auto& posting : postings_) {
+        std::vector<uint32_t>().swap(posting);
+    }
+    current_block_ = UINT64_MAX;
+    pruned_block_ = 0;
+}
+
+// 从最短的块列表出发，依次在其余列表中前向查找
+bool LogSearchIndex::CandidateBlocks(std::string_view query, uint64_t begin_id,
+                                     std::vector<uint64_t>& blocks) const {
+    blocks.clear();
+    if (query.size() < kMinQueryBytes) return false;
+
+    std::vector<uint32_t> buckets;
+    const auto* p = reinterpret_cast<const unsigned char*>(query.data());
+    for (size_t i = 0; i + 2 < query.size(); ++i) {
+        buckets.push_back(Bucket(p[i], p[i + 1], p[i + 2]));
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+
+    const uint32_t begin_block = static_cast<uint32_t>(begin_id >> kBlockShift);
+    struct Range {
+        const uint32_t* it;
+        const uint32_t* end;
+    };
+    std::vector<Range> ranges;
+    ranges.reserve(buckets.size());
+    for (uint32_t bucket : buckets) {
+        const auto& posting = postings_[bucket];
+        const uint32_t* begin = posting.data();
+        const uint32_t* end = begin + posting.size();
+        begin = std::lower_bound(begin, end, begin_block);
+        if (begin == end) return true;
+        ranges.push_back({begin, end});
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+        return (a.end - a.it) < (b.end - b.it);
+    });
+
+    for (const uint32_t* it = ranges[0].it; it != ranges[0].end; ++it) {
+        const uint32_t block = *it;
+        bool all = true;
+        for (size_t r = 1; r < ranges.size(); ++r) {
+            Range& range = ranges[r];
+            range.it = std::lower_bound(range.it, range.end, block);
+            if (range.it == range.end) return true;
+            if (*range.it != block) {
+                all = false;
+                break;
+            }
+        }
+        if (all) blocks.push_back(block);
+    }
+    return true;
+}
+
+size_t LogSearchIndex::MemoryBytes() const {
+    size_t bytes = postings_.size() * sizeof(std::vector<uint32_t>) + kBuckets / 8;
+    for (const auto& posting : postings_) {
+        bytes += posting.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+// 以模式中的某个字节为锚点用memchr跳跃：优先选非字母字节，全是字母时同时跟踪首字母的大小写两种形式
+size_t LogSearchIndex::FindIgnoreCase(std::string_view text, std::string_view pattern, size_t from) {
+    if (pattern.empty()) return from <= text.size() ? from : std::string_view::npos;
+    if (pattern.size() > text.size() || from > text.size() - pattern.size()) return std::string_view::npos;
+
+    size_t anchor = 0;
+    while (anchor < pattern.size() && IsAsciiLetter(static_cast<unsigned char>(pattern[anchor]))) ++anchor;
+    const bool letter_anchor = anchor == pattern.size();
+    if (letter_anchor) anchor = 0;
+
+    const unsigned char anchor_byte = static_cast<unsigned char>(pattern[anchor]);
+    const unsigned char lower = FoldAscii(anchor_byte);
+    const unsigned char upper = letter_anchor ? static_cast<unsigned char>(lower - ('a' - 'A')) : lower;
+
+    const char* const base = text.data();
+    const char* const scan_end = base + (text.size() - pattern.size()) + anchor + 1;
+    const char* p = base + from + anchor;
+    const char* next_lower = nullptr;
+    const char* next_upper = nullptr;
+
+    while (p < scan_end) {
+        const char* hit;
+        if (!letter_anchor) {
+            hit = static_cast<const char*>(memchr(p, lower, static_cast<size_t>(scan_end - p)));
+        } else {
+            if (!next_lower || next_lower < p) {
+                next_lower = static_cast<const char*>(memchr(p, lower, static_cast<size_t>(scan_end - p)));
+                if (!next_lower) next_lower = scan_end;
+            }
+            if (!next_upper || next_upper < p) {
+                next_upper = static_cast<const char*>(memchr(p, upper, static_cast<size_t>(scan_end - p)));
+                if (!next_upper) next_upper = scan_end;
+            }
+            hit = std::min(next_lower, next_upper);
+            if (hit == scan_end) hit = nullptr;
+        }
+        if (!hit) break;
+
+        const char* candidate = hit - anchor;
+        size_t k = 0;
+        while (k < pattern.size() &&
+               FoldAscii(static_cast<unsigned char>(candidate[k])) == FoldAscii(static_cast<unsigned char>(pattern[k]))) {
+            ++k;
+        }
+        if (k == pattern.size()) return static_cast<size_t>(candidate - base);
+        p = hit + 1;
+    }
+    return std::string_view::npos;
+}
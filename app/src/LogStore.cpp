@@ -0,0 +1,252 @@
+#include "LogStore.h"
+#include "AnsiParser.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // 去掉ANSI转义序列：on_text依次收到可见文本片段，颜色变化时on_color(文本偏移, 颜色)
+    // 相邻同色片段合并为一段，开头的默认色不记录；段数达到上限后其余文本沿用最后一段的颜色
+    template<typename TextFn, typename ColorFn>
+    void StripAnsi(std::string_view line, TextFn&& on_text, ColorFn&& on_color) {
+        size_t text_offset = 0;
+        size_t runs = 0;
+        uint32_t current = kAnsiDefaultColor;
+        ParseAnsiRuns(line, [&](const AnsiRun& run) {
+            if (run.color != current && runs < kLogMaxRuns) {
+                on_color(text_offset, run.color);
+                current = run.color;
+                ++runs;
+            }
+            on_text(line.substr(run.offset, run.length));
+            text_offset += run.length;
+        });
+    }
+}
+
+// 块大小不再统一，按起始行号二分查找所在块；早于第一个内存块的行位于冷层段中
+LogLineView LogSnapshot::ViewById(uint64_t id) const {
+    if (chunks_.empty() || id < chunks_.front()->first_id) {
+        auto it = std::upper_bound(segments_.begin(), segments_.end(), id,
+                                   [](uint64_t value, const LogColdSegmentPtr& segment) {
+                                       return value < segment->FirstId();
+                                   });
+        const LogColdSegment& segment = **(it - 1);
+        return segment.View(static_cast<size_t>(id - segment.FirstId()));
+    }
+
+    auto it = std::upper_bound(chunks_.begin(), chunks_.end(), id,
+                               [](uint64_t value, const std::shared_ptr<const LogChunk>& chunk) {
+                                   return value < chunk->first_id;
+                               });
+    const LogChunk& chunk = **(it - 1);
+    return chunk.View(static_cast<size_t>(id - chunk.first_id));
+}
+
+LogStore::LogStore(size_t max_bytes, size_t max_lines)
+    : max_bytes_(max_bytes), max_lines_(max_lines) {
+}
+
+void LogStore::SetLimits(size_t max_bytes, size_t max_lines) {
+    max_bytes_ = max_bytes;
+    max_lines_ = max_lines;
+    Evict();
+    ++generation_;
+}
+
+// 第一遍只统计去掉转义序列后的长度和颜色段数，第二遍直接写入块的字节区；没有转义序列的行只做一次memcpy
+// 日志级别按去掉转义序列后的文本识别，显示时只需查级别颜色表
+void LogStore::Push(std::string_view line) {
+    const bool timed = ++perf_sample_counter_ % kPerfSampleInterval == 0;
+    const uint64_t ansi_begin = timed ? PerfNowNs() : 0;
+
+    size_t text_length = 0;
+    size_t run_count = 0;
+    StripAnsi(line,
+              [&](std::string_view piece) { text_length += piece.size(); },
+              [&](size_t, uint32_t) { ++run_count; });
+    const size_t record = text_length + run_count * sizeof(LogColorRun);
+
+    if (chunks_.empty() || !chunks_.back()->CanFit(record)) {
+        // 超长行单独占用一个按需大小的块
+        chunks_.push_back(std::make_shared<LogChunk>(end_id_, std::max(LogChunk::kBytes, record)));
+        retained_bytes_ += chunks_.back()->AllocatedBytes();
+    }
+
+    LogChunk& chunk = *chunks_.back();
+    char* const text = chunk.bytes.get() + chunk.byte_used;
+    if (text_length == line.size()) {
+        if (!line.empty()) memcpy(text, line.data(), line.size());
+    } else {
+        char* out = text;
+        char* runs = text + text_length;
+        StripAnsi(line,
+                  [&](std::string_view piece) {
+                      memcpy(out, piece.data(), piece.size());
+                      out += piece.size();
+                  },
+                  [&](size_t offset, uint32_t color) {
+                      const LogColorRun run{static_cast<uint32_t>(offset), color};
+                      memcpy(runs, &run, sizeof(run));
+                      runs += sizeof(run);
+                  });
+    }
+
+    const uint64_t level_begin = timed ? PerfNowNs() : 0;
+    const LogLevel level = ClassifyLogLevel({text, text_length});
+    if (timed) {
+        PerfCounters& perf = PerfCounters::Global();
+        perf.ansi_ns.fetch_add((level_begin - ansi_begin) * kPerfSampleInterval, std::memory_order_relaxed);
+        perf.level_ns.fetch_add((PerfNowNs() - level_begin) * kPerfSampleInterval, std::memory_order_relaxed);
+    }
+
+    chunk.lines[chunk.line_count] = {
+        static_cast<uint32_t>(chunk.byte_used),
+        static_cast<uint32_t>(text_length),
+        MakeLogLineFlags(run_count, level)
+    };
+    chunk.byte_used += record;
+    ++chunk.line_count;
+    if (search_index_) search_index_->Add(end_id_, {text, text_length});
+    ++end_id_;
+
+    Evict();
+    ++generation_;
+}
+
+// 行号继续递增，旧块交给仍持有它们的快照释放
+void LogStore::Clear() {
+    chunks_.clear();
+    if (cold_tier_) cold_tier_->Clear();
+    if (search_index_) search_index_->Clear();
+    begin_id_ = end_id_;
+    retained_bytes_ = 0;
+    ++generation_;
+}
+
+void LogStore::PopFrontChunk() {
+    retained_bytes_ -= chunks_.front()->AllocatedBytes();
+    if (cold_tier_) cold_tier_->Append(std::move(chunks_.front()));
+    chunks_.pop_front();
+}
+
+// 超出字节预算时整块淘汰最旧的块(只有整块释放才能归还内存)，最新的块不淘汰；
+// 超出行数上限时逐行前移起始行号，整块落到起始行之前时摘除该块
+void LogStore::Evict() {
+    while (Size() > 1) {
+        const LogChunk& front = *chunks_.front();
+        const uint64_t front_end = front.first_id + front.line_count;
+        if (retained_bytes_ > max_bytes_ && chunks_.size() > 1) {
+            begin_id_ = front_end;
+            PopFrontChunk();
+        } else if (max_lines_ > 0 && Size() > max_lines_) {
+            ++begin_id_;
+            if (begin_id_ == front_end) PopFrontChunk();
+        } else {
+            break;
+        }
+    }
+    if (search_index_) search_index_->PruneBefore(begin_id_);
+}
+
+void LogStore::EnableColdTier(const std::filesystem::path& dir, uint64_t max_disk_bytes) {
+    if (cold_tier_) {
+        cold_tier_->SetMaxDiskBytes(max_disk_bytes);
+    } else {
+        cold_tier_ = std::make_unique<LogColdTier>(dir, max_disk_bytes);
+    }
+    ++generation_;
+}
+
+std::unique_ptr<LogColdTier> LogStore::DisableColdTier() {
+    ++generation_;
+    return std::move(cold_tier_);
+}
+
+void LogStore::MaintainColdTier() {
+    if (!cold_tier_) return;
+    if (cold_tier_->Collect()) ++generation_;
+    cold_tier_->TrimResident();
+}
+
+// 开启时为当前保留的行补建索引
+void LogStore::SetSearchIndexEnabled(bool enable) {
+    if (!enable) {
+        search_index_.reset();
+        return;
+    }
+    if (search_index_) return;
+
+    search_index_ = std::make_unique<LogSearchIndex>();
+    for (uint64_t id = begin_id_; id < end_id_; ++id) {
+        search_index_->Add(id, LineById(id));
+    }
+}
+
+std::string_view LogStore::LineById(uint64_t id) const {
+    auto it = std::upper_bound(chunks_.begin(), chunks_.end(), id,
+                               [](uint64_t value, const std::shared_ptr<LogChunk>& chunk) {
+                                   return value < chunk->first_id;
+                               });
+    const LogChunk& chunk = **(it - 1);
+    return chunk.Line(static_cast<size_t>(id - chunk.first_id));
+}
+
+// 从最新的行往前确认候选，结果够数即停止
+std::vector<uint64_t> LogStore::Search(std::string_view query, size_t max_results, uint64_t from_id) const {
+    std::vector<uint64_t> results;
+    const uint64_t begin = std::max(begin_id_, from_id);
+    if (query.empty() || begin >= end_id_ || max_results == 0) return results;
+
+    auto match_range = [&](uint64_t first, uint64_t last) {
+        for (uint64_t id = last; id-- > first;) {
+            if (LogSearchIndex::FindIgnoreCase(LineById(id), query) != std::string_view::npos) {
+                results.push_back(id);
+                if (results.size() >= max_results) return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<uint64_t> blocks;
+    if (search_index_ && search_index_->CandidateBlocks(query, begin, blocks)) {
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+            const uint64_t first = std::max(*it << LogSearchIndex::kBlockShift, begin);
+            const uint64_t last = std::min((*it + 1) << LogSearchIndex::kBlockShift, end_id_);
+            if (first < last && !match_range(first, last)) break;
+        }
+    } else {
+        match_range(begin, end_id_);
+    }
+
+    std::reverse(results.begin(), results.end());
+    return results;
+}
+
+LogSnapshotPtr LogStore::Snapshot() const {
+    if (cached_snapshot_ && cached_snapshot_->generation_ == generation_) {
+        return cached_snapshot_;
+    }
+
+    auto snapshot = std::make_shared<LogSnapshot>();
+    snapshot->generation_ = generation_;
+    snapshot->begin_id_ = begin_id_;
+
+    if (cold_tier_) {
+        // 冷层段 + 待写块 + 内存块首尾相接，front块中已移出预算但尚未淘汰的行也一并可见
+        snapshot->segments_ = cold_tier_->Segments();
+        snapshot->chunks_ = cold_tier_->Pending();
+        snapshot->cold_disk_bytes_ = cold_tier_->DiskBytes();
+        if (!cold_tier_->Empty()) {
+            snapshot->begin_id_ = cold_tier_->BeginId();
+        } else if (!chunks_.empty()) {
+            snapshot->begin_id_ = chunks_.front()->first_id;
+        }
+    }
+    snapshot->chunks_.insert(snapshot->chunks_.end(), chunks_.begin(), chunks_.end());
+    snapshot->end_id_ = end_id_;
+    snapshot->retained_bytes_ = retained_bytes_;
+
+    cached_snapshot_ = std::move(snapshot);
+    return cached_snapshot_;
+}
@@ -1,14 +1,28 @@
 #include "Manager.h"
 #include <cstdio>
 #include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
+#include <thread>
 
 
 #include "imgui_internal.h"
 #include "resource.h"
 #include "Units.h"
 
+namespace {
+    ImVec4 ToImVec4(const LogColor &color) {
+        return ImVec4(color.x, color.y, color.z, color.w);
+    }
+
+    LogColor ToLogColor(const ImVec4 &color) {
+        return LogColor{color.x, color.y, color.z, color.w};
+    }
+}
+
 Manager::Manager() = default;
 
 Manager::~Manager() {
@@ -108,10 +122,20 @@ bool Manager::Initialize() {
     // 初始化托盘
     if (!InitializeTray()) return false;
 
+    // 新日志到达或后台过滤完成时唤醒主循环(在其他线程调用，两个后端的唤醒方式都是线程安全的)
+#ifdef USE_WIN32_BACKEND
+    std::function<void()> wake = [hwnd = m_hwnd]() { PostMessage(hwnd, WM_NULL, 0, 0); };
+#else
+    std::function<void()> wake = []() { glfwPostEmptyEvent(); };
+#endif
+    m_app_state.cli_process.SetIngestWakeCallback(wake);
+    log_filter_view_.SetWakeCallback(wake);
+
     // 初始化应用状态
     m_app_state.LoadSettings();
     m_app_state.auto_start = IsAutoStartEnabled();
     m_app_state.ApplySettings();
+    m_app_state.ApplyLogFileSettings();
     m_app_state.SaveSettings();
 
     LoadSavedTheme();
@@ -138,15 +162,20 @@ void Manager::Run() {
     if (!m_initialized) return;
 
     while (!ShouldExit()) {
+        WaitForFrame();
         HandleMessages();
 
         if (m_should_exit) break;
+
+        // 每帧一次批量取出读取线程产生的日志(窗口隐藏时同样需要，避免队列积满)
+        m_app_state.cli_process.DrainIngestQueue();
+
         UpdateDPIScale();
         if (m_app_state.settings_dirty) {
             m_app_state.SaveSettings();
         }
 
-        if (m_app_state.show_main_window) {
+        if (m_app_state.show_main_window && !IsMainWindowMinimized()) {
 #ifdef USE_WIN32_BACKEND
             // Win32 渲染循环
             ImGui_ImplDX11_NewFrame();
@@ -162,6 +191,7 @@ void Manager::Run() {
             ImGui_ImplGlfw_NewFrame();
 #endif
 
+            const uint64_t frame_begin = PerfNowNs();
             ImGui::NewFrame();
             RenderUI();
             ImGui::Render();
@@ -171,6 +201,8 @@ void Manager::Run() {
             m_pd3dDeviceContext->OMSetRenderTargets(1, &m_mainRenderTargetView, nullptr);
             m_pd3dDeviceContext->ClearRenderTargetView(m_mainRenderTargetView, clearColor);
             ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+            // 帧耗时不含等待垂直同步
+            RecordFrameTime(PerfNowNs() - frame_begin);
             m_pSwapChain->Present(1, 0);
 #else
             int display_w, display_h;
@@ -179,19 +211,17 @@ void Manager::Run() {
             glClearColor(0.1f, 0.1f, 0.1f, 1.00f);
             glClear(GL_COLOR_BUFFER_BIT);
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            RecordFrameTime(PerfNowNs() - frame_begin);
             glfwSwapBuffers(m_window);
 #endif
-        } else {
-#ifdef USE_WIN32_BACKEND
-            WaitMessage();
-#else
-            glfwWaitEvents();
-#endif
-        }
-    }
 
-    if (m_app_state.settings_dirty) {
-        m_app_state.SaveSettings();
+            m_last_frame_time = std::chrono::steady_clock::now();
+            if (m_redraw_frames > 0) --m_redraw_frames;
+            // 拖动、输入等交互进行中时持续绘制
+            if (ImGui::IsAnyItemActive() || ImGui::IsAnyMouseDown()) {
+                m_redraw_frames = std::max(m_redraw_frames, 1);
+            }
+        }
     }
 }
 
@@ -331,6 +361,8 @@ void Manager::RenderMenuBar() {
                                 (dockspace_flags & ImGuiDockNodeFlags_PassthruCentralNode) != 0,
                                 m_fullscreen)) { dockspace_flags ^= ImGuiDockNodeFlags_PassthruCentralNode; }
             ImGui::Separator();
+            ImGui::MenuItem("性能监视(Performance)", nullptr, &show_perf_overlay_);
+            ImGui::Separator();
             //不关闭菜单
             if (ImGui::MenuItem("关闭(Close)", nullptr, !m_app_state.show_main_window)) {
                 HideMainWindow();
@@ -585,6 +617,74 @@ void Manager::RenderMainContent() {
         RenderCommandPanel(buttonWidth, inputWidth);
     }
     ImGui::End();
+
+    if (show_log_file_viewer_) {
+        ImGui::SetNextWindowSize(ImVec2(900 * m_dpi_scale, 600 * m_dpi_scale), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("历史日志", &show_log_file_viewer_)) {
+            RenderLogFileViewer();
+        }
+        ImGui::End();
+    }
+
+    if (show_perf_overlay_) {
+        RenderPerfOverlay();
+    }
+}
+
+void Manager::RecordFrameTime(uint64_t frame_ns) {
+    PerfCounters& perf = PerfCounters::Global();
+    perf.frames.fetch_add(1, std::memory_order_relaxed);
+    perf.frame_ns.fetch_add(frame_ns, std::memory_order_relaxed);
+    frame_times_ms_[frame_time_count_ % kFrameTimeSamples] = static_cast<float>(frame_ns) / 1e6f;
+    ++frame_time_count_;
+}
+
+// 每秒更新一次速率，两次之间显示上一次的结果
+void Manager::RenderPerfOverlay() {
+    const PerfCounters::Sample now = PerfCounters::Global().Load();
+    const uint64_t elapsed_ns = now.time_ns - perf_last_sample_.time_ns;
+    if (perf_last_sample_.time_ns == 0) {
+        perf_last_sample_ = now;
+    } else if (elapsed_ns >= 1000000000ull) {
+        const PerfCounters::Sample &last = perf_last_sample_;
+        const double seconds = static_cast<double>(elapsed_ns) / 1e9;
+        auto per_sec = [seconds](uint64_t current, uint64_t previous) {
+            return static_cast<double>(current - previous) / seconds;
+        };
+        perf_rates_.lines_per_sec = per_sec(now.read_lines, last.read_lines);
+        perf_rates_.bytes_per_sec = per_sec(now.read_bytes, last.read_bytes);
+        perf_rates_.conversion_ms = per_sec(now.conversion_ns, last.conversion_ns) / 1e6;
+        perf_rates_.ansi_ms = per_sec(now.ansi_ns, last.ansi_ns) / 1e6;
+        perf_rates_.level_ms = per_sec(now.level_ns, last.level_ns) / 1e6;
+        perf_rates_.lock_wait_ms = per_sec(now.logs_lock_wait_ns, last.logs_lock_wait_ns) / 1e6;
+
+        const size_t count = std::min(frame_time_count_, kFrameTimeSamples);
+        if (count > 0) {
+            std::array<float, kFrameTimeSamples> sorted = frame_times_ms_;
+            std::sort(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(count));
+            perf_rates_.frame_p50_ms = sorted[count / 2];
+            perf_rates_.frame_p99_ms = sorted[std::min(count - 1, count * 99 / 100)];
+        }
+        perf_last_sample_ = now;
+    }
+
+    const CLIProcess::IngestStats ingest = m_app_state.cli_process.GetIngestStats();
+
+    ImGui::SetNextWindowBgAlpha(0.85f);
+    if (ImGui::Begin("性能监视", &show_perf_overlay_,
+                     ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoDocking)) {
+        ImGui::Text("帧耗时: p50 %.2f ms  p99 %.2f ms", perf_rates_.frame_p50_ms, perf_rates_.frame_p99_ms);
+        ImGui::Text("接收: %.0f 行/秒  %.2f MB/秒", perf_rates_.lines_per_sec,
+                    perf_rates_.bytes_per_sec / (1024.0 * 1024.0));
+        ImGui::Text("接收队列: %zu / %zu", ingest.queue_depth, ingest.queue_capacity);
+        ImGui::Separator();
+        ImGui::Text("每秒耗时:");
+        ImGui::Text("  编码转换: %.2f ms", perf_rates_.conversion_ms);
+        ImGui::Text("  ANSI解析: %.2f ms", perf_rates_.ansi_ms);
+        ImGui::Text("  级别识别: %.2f ms", perf_rates_.level_ms);
+        ImGui::Text("  日志锁等待: %.2f ms", perf_rates_.lock_wait_ms);
+    }
+    ImGui::End();
 }
 
 void Manager::RenderSettingsMenu() {
@@ -600,11 +700,79 @@ void Manager::RenderSettingsMenu() {
     }
     ImGui::Separator();
     ImGui::Text("日志设置");
-    if (ImGui::InputInt("最大日志行数", &m_app_state.max_log_lines, 100, 500)) {
-        m_app_state.max_log_lines = std::max(100, std::min(m_app_state.max_log_lines, 10000));
+    int max_log_mb = static_cast<int>(m_app_state.max_log_bytes >> 20);
+    if (ImGui::InputInt("日志内存上限(MB)", &max_log_mb, 16, 256)) {
+        max_log_mb = std::max(1, std::min(max_log_mb, 16 * 1024));
+        m_app_state.max_log_bytes = static_cast<uint64_t>(max_log_mb) << 20;
+        m_app_state.cli_process.SetMaxLogBytes(m_app_state.max_log_bytes);
+        m_app_state.settings_dirty = true;
+    }
+    if (ImGui::InputInt("最大日志行数(0为不限)", &m_app_state.max_log_lines, 1000, 100000)) {
+        m_app_state.max_log_lines = std::max(0, m_app_state.max_log_lines);
         m_app_state.cli_process.SetMaxLogLines(m_app_state.max_log_lines);
         m_app_state.settings_dirty = true;
     }
+    if (ImGui::MenuItem("搜索索引", nullptr, m_app_state.enable_search_index)) {
+        m_app_state.enable_search_index = !m_app_state.enable_search_index;
+        m_app_state.cli_process.SetSearchIndexEnabled(m_app_state.enable_search_index);
+        m_app_state.settings_dirty = true;
+    }
+    if (ImGui::MenuItem("超出内存的日志转存磁盘", nullptr, m_app_state.enable_cold_log_tier)) {
+        m_app_state.enable_cold_log_tier = !m_app_state.enable_cold_log_tier;
+        m_app_state.cli_process.SetColdLogTier(m_app_state.enable_cold_log_tier, m_app_state.max_cold_log_bytes);
+        m_app_state.settings_dirty = true;
+    }
+    if (m_app_state.enable_cold_log_tier) {
+        int max_cold_gb = static_cast<int>(m_app_state.max_cold_log_bytes >> 30);
+        if (ImGui::InputInt("磁盘转存上限(GB)", &max_cold_gb, 1, 10)) {
+            max_cold_gb = std::max(1, std::min(max_cold_gb, 1024));
+            m_app_state.max_cold_log_bytes = static_cast<uint64_t>(max_cold_gb) << 30;
+            m_app_state.cli_process.SetColdLogTier(true, m_app_state.max_cold_log_bytes);
+            m_app_state.settings_dirty = true;
+        }
+    }
+
+    ImGui::Separator();
+    ImGui::Text("日志文件设置");
+    if (ImGui::MenuItem("保存输出到文件", nullptr, m_app_state.enable_log_file)) {
+        m_app_state.enable_log_file = !m_app_state.enable_log_file;
+        m_app_state.ApplyLogFileSettings();
+        m_app_state.settings_dirty = true;
+    }
+    // 编辑完成后才重启写入，避免每次按键都轮转出新文件
+    ImGui::InputText("日志目录", m_app_state.log_file_directory, IM_ARRAYSIZE(m_app_state.log_file_directory));
+    bool log_file_changed = ImGui::IsItemDeactivatedAfterEdit();
+    if (ImGui::InputInt("单文件上限(MB)", &m_app_state.log_file_max_mb, 16, 256)) {
+        m_app_state.log_file_max_mb = std::max(1, std::min(m_app_state.log_file_max_mb, 4096));
+    }
+    log_file_changed |= ImGui::IsItemDeactivatedAfterEdit();
+    if (ImGui::InputInt("轮转间隔(分钟,0为不限)", &m_app_state.log_file_max_age_min, 10, 60)) {
+        m_app_state.log_file_max_age_min = std::max(0, m_app_state.log_file_max_age_min);
+    }
+    log_file_changed |= ImGui::IsItemDeactivatedAfterEdit();
+    if (ImGui::MenuItem("压缩已轮转的文件", nullptr, m_app_state.compress_log_files)) {
+        m_app_state.compress_log_files = !m_app_state.compress_log_files;
+        log_file_changed = true;
+    }
+    if (log_file_changed) {
+        if (m_app_state.enable_log_file) m_app_state.ApplyLogFileSettings();
+        m_app_state.settings_dirty = true;
+    }
+    if (ImGui::MenuItem("浏览历史日志")) {
+        show_log_file_viewer_ = true;
+        RefreshLogFileList();
+    }
+
+    ImGui::Separator();
+    ImGui::Text("界面设置");
+    if (ImGui::InputInt("最大帧率", &m_app_state.max_fps, 10, 30)) {
+        m_app_state.max_fps = std::max(10, std::min(m_app_state.max_fps, 240));
+        m_app_state.settings_dirty = true;
+    }
+    if (ImGui::MenuItem("失去焦点时节能", nullptr, m_app_state.power_save_unfocused)) {
+        m_app_state.power_save_unfocused = !m_app_state.power_save_unfocused;
+        m_app_state.settings_dirty = true;
+    }
 
     // 新增：命令历史记录设置
     ImGui::Separator();
@@ -777,10 +945,19 @@ void Manager::RenderOutputEncodingSettings() {
     ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "当前: %s",
                        CLIProcess::GetEncodingName(m_app_state.output_encoding).c_str());
 
+    if (m_app_state.output_encoding == OutputEncoding::AUTO_DETECT) {
+        const EncodingDetector::Result detected = m_app_state.cli_process.GetDetectedEncoding();
+        if (detected.confidence > 0.0f) {
+            ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "识别为: %s (置信度 %.0f%%%s)",
+                               CLIProcess::GetEncodingName(detected.encoding).c_str(),
+                               detected.confidence * 100.0f, detected.locked ? ", 已锁定" : "");
+        }
+    }
+
     // 编码说明
     ImGui::Spacing();
     ImGui::TextWrapped("说明：");
-    ImGui::BulletText("自动检测：程序会尝试自动识别输出编码并转换为UTF-8显示");
+    ImGui::BulletText("自动检测：按字节分布识别输出编码并转换为UTF-8显示，识别结果可靠后锁定，出现解码错误时重新识别");
     ImGui::BulletText("UTF-8：适用于现代程序和国际化应用");
     ImGui::BulletText("GBK/GB2312：适用于中文Windows系统的程序");
     ImGui::BulletText("Big5：适用于繁体中文程序");
@@ -880,6 +1057,9 @@ void Manager::RenderCommandPanel(float buttonWidth, float inputWidth) {
 }
 
 void Manager::RenderLogPanel() {
+    // 整帧使用同一个快照，读取期间读取线程的写入和淘汰不会影响它
+    const LogSnapshotPtr logs = m_app_state.cli_process.GetLogSnapshot();
+
     // 日志控制工具栏
     if (ImGui::BeginTable("LogControls", 3, ImGuiTableFlags_SizingStretchProp)) {
         ImGui::TableSetupColumn("Actions", ImGuiTableColumnFlags_WidthFixed, 85.0f * m_dpi_scale);
@@ -904,48 +1084,204 @@ void Manager::RenderLogPanel() {
 
         // 状态列
         ImGui::TableNextColumn();
-        ImGui::Text("行数: %d/%d",
-                    static_cast<int>(m_app_state.cli_process.GetLogs().size()),
-                    m_app_state.max_log_lines);
+        if (m_app_state.max_log_lines > 0) {
+            ImGui::Text("行数: %llu/%d", static_cast<unsigned long long>(logs->Size()), m_app_state.max_log_lines);
+        } else {
+            ImGui::Text("行数: %llu", static_cast<unsigned long long>(logs->Size()));
+        }
+        ImGui::Text("内存: %.1f/%.0f MB",
+                    static_cast<double>(logs->RetainedBytes()) / (1024.0 * 1024.0),
+                    static_cast<double>(m_app_state.max_log_bytes) / (1024.0 * 1024.0));
+        if (m_app_state.enable_cold_log_tier) {
+            ImGui::Text("磁盘: %.1f MB", static_cast<double>(logs->ColdDiskBytes()) / (1024.0 * 1024.0));
+        }
+        if (m_app_state.cli_process.IsLogFileEnabled()) {
+            const auto file_stats = m_app_state.cli_process.GetLogFileStats();
+            ImGui::Text("文件: %.1f MB  丢弃: %.1f MB",
+                        static_cast<double>(file_stats.written_bytes) / (1024.0 * 1024.0),
+                        static_cast<double>(file_stats.dropped_bytes) / (1024.0 * 1024.0));
+        }
+        const auto ingest = m_app_state.cli_process.GetIngestStats();
+        ImGui::Text("队列: %d/%d  丢弃: %llu",
+                    static_cast<int>(ingest.queue_depth),
+                    static_cast<int>(ingest.queue_capacity),
+                    static_cast<unsigned long long>(ingest.dropped_lines));
     }
     ImGui::EndTable();
 
-    ImGui::Separator();
+    // 搜索栏：输入即查询(不足3字节的查询按回车后才查询)，日志更新后限频增量查询
+    ImGui::SetNextItemWidth(-230.0f * m_dpi_scale);
+    const bool search_changed = ImGui::InputTextWithHint("##LogSearch", "搜索日志(不区分大小写)",
+                                                         log_search_, IM_ARRAYSIZE(log_search_));
+    UpdateLogSearch(*logs, search_changed, ImGui::IsItemDeactivated());
+    const int match_count = static_cast<int>(log_search_results_.size());
+    ImGui::SameLine();
+    if (ImGui::Button("上一个") && match_count > 0) {
+        log_search_cursor_ = log_search_cursor_ <= 0 ? match_count - 1 : log_search_cursor_ - 1;
+        log_search_scroll_pending_ = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("下一个") && match_count > 0) {
+        log_search_cursor_ = (log_search_cursor_ + 1) % match_count;
+        log_search_scroll_pending_ = true;
+    }
+    ImGui::SameLine();
+    if (log_search_[0] != '\0' && !log_search_active_) {
+        ImGui::TextDisabled("按回车搜索");
+    } else if (log_search_[0] != '\0') {
+        ImGui::Text("%d/%d  %.1fms", log_search_cursor_ + 1, match_count, log_search_ms_);
+    }
 
-    // 日志内容区域
-    if (ImGui::BeginChild("LogContent", ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar)) {
-        const auto &logs = m_app_state.cli_process.GetLogs();
+    // 过滤栏：更换条件时后台重新过滤，之后每帧只检查新到达的行
+    ImGui::SetNextItemWidth(-230.0f * m_dpi_scale);
+    if (ImGui::InputTextWithHint("##LogFilter", "只显示包含此文本的行", log_filter_input_,
+                                 IM_ARRAYSIZE(log_filter_input_))) {
+        log_filter_view_.SetPattern(log_filter_input_, logs);
+    }
+    log_filter_view_.Update(*logs);
+    if (log_filter_view_.Active()) {
+        ImGui::SameLine();
+        if (log_filter_view_.Scanning()) {
+            ImGui::ProgressBar(log_filter_view_.Progress(), ImVec2(220.0f * m_dpi_scale, 0), "过滤中...");
+        } else {
+            ImGui::Text("显示 %d 行", static_cast<int>(log_filter_view_.Size()));
+        }
+    }
 
-        // 使用ImGuiListClipper优化大量日志的渲染性能
-        ImGuiListClipper clipper;
-        clipper.Begin(static_cast<int>(logs.size()));
+    ImGui::Separator();
 
-        while (clipper.Step()) {
-            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-                const std::string &log = logs[i];
+    // 日志内容区域：纵向位置是64位行号(见LogLineScroller)，只绘制可见的行，冷层中的大量日志也能精确定位
+    const float log_area_height = ImGui::GetContentRegionAvail().y;
+    if (ImGui::BeginChild("LogContent", ImVec2(-LogLineScroller::ScrollbarWidth(), 0), true,
+                          ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoScrollWithMouse)) {
+        const bool searching = log_search_[0] != '\0';
+        const uint64_t current_match = log_search_cursor_ >= 0 && log_search_cursor_ < static_cast<int>(log_search_results_.size())
+                                           ? log_search_results_[log_search_cursor_]
+                                           : UINT64_MAX;
+        // 过滤时按匹配行号列表显示，否则直接按快照顺序显示
+        const bool filtering = log_filter_view_.Active();
+        const size_t row_count = filtering ? log_filter_view_.Size() : logs->Size();
+
+        bool jumped = false;
+        if (log_search_scroll_pending_ && current_match >= logs->BeginId() && current_match < logs->EndId()) {
+            const size_t row = filtering ? log_filter_view_.RowOf(current_match)
+                                         : static_cast<size_t>(current_match - logs->BeginId());
+            if (row != SIZE_MAX) {
+                log_scroll_.ScrollTo(row, 0.5f);
+                jumped = true;
+            }
+        }
+        log_search_scroll_pending_ = false;
+
+        // 自动滚动：停在末尾时随新日志保持在末尾(刚跳转到搜索结果时除外)
+        log_scroll_.Begin(row_count, !jumped && m_app_state.auto_scroll_logs);
+        {
+            for (int i = 0; i < log_scroll_.Count(); i++) {
+                const uint64_t row = log_scroll_.First() + static_cast<uint64_t>(i);
+                const uint64_t id = filtering ? log_filter_view_.IdAt(static_cast<size_t>(row)) : logs->BeginId() + row;
+                const LogLineView line = logs->ViewById(id);
+                const std::string_view log = line.text;
+                if (searching) {
+                    DrawSearchHighlights(log, id == current_match);
+                }
 
                 if (m_app_state.enable_colored_logs) {
                     if (m_app_state.use_ansi_colors) {
-                        // 使用ANSI颜色转义序列解析
-                        RenderColoredLogLine(log);
+                        // 使用入库时解析好的ANSI颜色段
+                        RenderColoredLogLine(line);
                     } else {
                         // 仅使用日志级别的颜色区分
-                        ImVec4 textColor = GetCustomLogLevelColor(log);
-                        ImGui::TextColored(textColor, "%s", log.c_str());
+                        ImVec4 textColor = GetCustomLogLevelColor(line.Level());
+                        ImGui::TextColored(textColor, "%.*s", static_cast<int>(log.size()), log.data());
                     }
                 } else {
                     // 不启用彩色显示，使用默认白色
-                    ImGui::TextUnformatted(log.c_str());
+                    ImGui::TextUnformatted(log.data(), log.data() + log.size());
                 }
             }
         }
-
-        // 自动滚动到底部
-        if (m_app_state.auto_scroll_logs && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
-            ImGui::SetScrollHereY(1.0f);
-        }
     }
     ImGui::EndChild();
+    ImGui::SameLine();
+    log_scroll_.DrawScrollbar("##LogPosition", log_area_height);
+}
+
+// 查询本身在日志锁内完成，因此尽量少查：
+// - 输入变化立即查询；不足3字节的查询用不上索引、要逐行扫描，输入时不查，按回车(或离开输入框)后才查
+// - 新日志到达时最多每250ms查询一次，且只查上次之后到达的行，结果追加到原有结果后
+void Manager::UpdateLogSearch(const LogSnapshot& logs, bool changed, bool confirmed) {
+    if (log_search_[0] == '\0') {
+        log_search_results_.clear();
+        log_search_cursor_ = -1;
+        log_search_active_ = false;
+        return;
+    }
+
+    if (changed) {
+        log_search_results_.clear();
+        log_search_cursor_ = -1;
+        log_search_end_ = 0;
+        log_search_active_ = strlen(log_search_) >= LogSearchIndex::kMinQueryBytes;
+    }
+    if (confirmed && !log_search_active_) {
+        log_search_active_ = true;
+        changed = true;
+    }
+    if (!log_search_active_) return;
+
+    const double now = ImGui::GetTime();
+    if (!changed && (logs.Generation() == log_search_generation_ || now - log_search_time_ < 0.25)) {
+        return;
+    }
+
+    const uint64_t previous = log_search_cursor_ >= 0 && log_search_cursor_ < static_cast<int>(log_search_results_.size())
+                                  ? log_search_results_[log_search_cursor_]
+                                  : UINT64_MAX;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<uint64_t> found = m_app_state.cli_process.SearchLogs(log_search_, kMaxSearchResults,
+                                                                           log_search_end_, log_search_end_);
+    log_search_ms_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    log_search_generation_ = logs.Generation();
+    log_search_time_ = now;
+
+    // 去掉已淘汰(或已清空)的行，追加新结果，超过上限时保留最新的
+    log_search_results_.erase(log_search_results_.begin(),
+                              std::lower_bound(log_search_results_.begin(), log_search_results_.end(), logs.BeginId()));
+    log_search_results_.insert(log_search_results_.end(), found.begin(), found.end());
+    if (log_search_results_.size() > kMaxSearchResults) {
+        log_search_results_.erase(log_search_results_.begin(),
+                                  log_search_results_.end() - static_cast<ptrdiff_t>(kMaxSearchResults));
+    }
+
+    // 新结果中保持选中原来的行
+    if (changed || previous == UINT64_MAX) {
+        log_search_cursor_ = -1;
+    } else {
+        const auto it = std::lower_bound(log_search_results_.begin(), log_search_results_.end(), previous);
+        log_search_cursor_ = (it != log_search_results_.end() && *it == previous)
+                                 ? static_cast<int>(it - log_search_results_.begin())
+                                 : -1;
+    }
+}
+
+// 存储的文本已去掉ANSI转义(颜色另存为颜色段)，与显示的文字逐字节一致，因此每处匹配都能精确标出
+void Manager::DrawSearchHighlights(std::string_view log, bool current) {
+    const std::string_view query(log_search_);
+    size_t pos = LogSearchIndex::FindIgnoreCase(log, query);
+    if (pos == std::string_view::npos) return;
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float height = ImGui::GetTextLineHeight();
+    const ImU32 color = current ? IM_COL32(255, 140, 0, 150) : IM_COL32(255, 220, 0, 80);
+
+    while (pos != std::string_view::npos) {
+        const float x0 = ImGui::CalcTextSize(log.data(), log.data() + pos).x;
+        const float x1 = x0 + ImGui::CalcTextSize(log.data() + pos, log.data() + pos + query.size()).x;
+        draw_list->AddRectFilled(ImVec2(origin.x + x0, origin.y), ImVec2(origin.x + x1, origin.y + height), color);
+        pos = LogSearchIndex::FindIgnoreCase(log, query, pos + query.size());
+    }
 }
 
 void Manager::RenderCommandHistory() {
@@ -1014,6 +1350,97 @@ void Manager::RenderCommandHistory() {
     }
 }
 
+// 只列出未压缩的日志，按文件名(即时间)倒序
+void Manager::RefreshLogFileList() {
+    log_files_.clear();
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(m_app_state.log_file_directory, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".log") {
+            log_files_.push_back(entry.path());
+        }
+    }
+    std::sort(log_files_.begin(), log_files_.end(), [](const auto& a, const auto& b) {
+        return a.filename().string() > b.filename().string();
+    });
+}
+
+// 借助旁路索引打开任意大小的日志：只映射文件，不扫描全文，默认定位到末尾
+void Manager::RenderLogFileViewer() {
+    if (ImGui::BeginChild("LogFileList", ImVec2(260 * m_dpi_scale, 0), true)) {
+        if (ImGui::Button("刷新列表")) {
+            RefreshLogFileList();
+        }
+        ImGui::Separator();
+        for (const auto& path : log_files_) {
+            const std::string name = path.filename().string();
+            if (ImGui::Selectable(name.c_str(), log_file_reader_.Path() == path)) {
+                if (log_file_reader_.Open(path)) {
+                    log_viewer_scroll_.ScrollTo(log_file_reader_.LineCount(), 1.0f);
+                }
+            }
+        }
+    }
+    ImGui::EndChild();
+
+    ImGui::SameLine();
+
+    ImGui::BeginGroup();
+    if (!log_file_reader_.IsOpen()) {
+        ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "选择一个日志文件(空文件无法打开)");
+        ImGui::EndGroup();
+        return;
+    }
+
+    ImGui::Text("行数: %llu  大小: %.1f MB",
+                static_cast<unsigned long long>(log_file_reader_.LineCount()),
+                static_cast<double>(log_file_reader_.FileBytes()) / (1024.0 * 1024.0));
+    ImGui::SameLine();
+    if (ImGui::Button("重新加载")) {
+        log_file_reader_.Refresh();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("末尾")) {
+        log_viewer_scroll_.ScrollTo(log_file_reader_.LineCount(), 1.0f);
+    }
+
+    ImGui::SetNextItemWidth(120 * m_dpi_scale);
+    ImGui::InputScalar("##JumpLine", ImGuiDataType_U64, &log_viewer_jump_line_);
+    ImGui::SameLine();
+    if (ImGui::Button("跳转到行")) {
+        log_viewer_scroll_.ScrollTo(log_viewer_jump_line_ > 0 ? log_viewer_jump_line_ - 1 : 0, 0.0f);
+    }
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(180 * m_dpi_scale);
+    ImGui::InputTextWithHint("##JumpTime", "YYYY-MM-DD HH:MM:SS", log_viewer_jump_time_,
+                             IM_ARRAYSIZE(log_viewer_jump_time_));
+    ImGui::SameLine();
+    if (ImGui::Button("跳转到时间")) {
+        std::tm local{};
+        std::istringstream input(log_viewer_jump_time_);
+        input >> std::get_time(&local, "%Y-%m-%d %H:%M:%S");
+        if (!input.fail()) {
+            local.tm_isdst = -1;
+            const int64_t time_ms = static_cast<int64_t>(std::mktime(&local)) * 1000;
+            log_viewer_scroll_.ScrollTo(log_file_reader_.LineAtTime(time_ms), 0.0f);
+        }
+    }
+
+    // 按64位行号定位(见LogLineScroller)，超过2^31行的文件也能完整浏览
+    const float content_height = ImGui::GetContentRegionAvail().y;
+    if (ImGui::BeginChild("LogFileContent", ImVec2(-LogLineScroller::ScrollbarWidth(), 0), true,
+                          ImGuiWindowFlags_HorizontalScrollbar | ImGuiWindowFlags_NoScrollWithMouse)) {
+        log_viewer_scroll_.Begin(log_file_reader_.LineCount(), false);
+        for (int i = 0; i < log_viewer_scroll_.Count(); ++i) {
+            const std::string_view line = log_file_reader_.Line(log_viewer_scroll_.First() + static_cast<uint64_t>(i));
+            ImGui::TextUnformatted(line.data(), line.data() + line.size());
+        }
+    }
+    ImGui::EndChild();
+    ImGui::SameLine();
+    log_viewer_scroll_.DrawScrollbar("##LogFilePosition", content_height);
+    ImGui::EndGroup();
+}
+
 void Manager::OnTrayShowWindow() {
     m_app_state.show_main_window = true;
     ShowMainWindow();
@@ -1201,6 +1628,58 @@ void Manager::HandleMessages() {
 #endif
 }
 
+// 事件驱动的重绘：没有输入和新日志时阻塞等待，不再每个垂直同步都重建整帧
+// 帧率受max_fps限制，失去焦点且开启节能时降为kPowerSaveFps；读取线程通过SetIngestWakeCallback唤醒
+void Manager::WaitForFrame() {
+    using clock = std::chrono::steady_clock;
+
+    if (!m_app_state.show_main_window || IsMainWindowMinimized()) {
+        WaitEvents(kHiddenWaitSeconds);
+        m_redraw_frames = kSettleFrames;
+        return;
+    }
+
+    // 间隔内到达的事件留在队列中，到点后一并处理
+    const bool power_save = m_app_state.power_save_unfocused && !IsMainWindowFocused();
+    const int fps = power_save ? kPowerSaveFps : std::max(1, m_app_state.max_fps);
+    const auto next_frame = m_last_frame_time +
+                            std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    if (clock::now() < next_frame) {
+        std::this_thread::sleep_until(next_frame);
+    }
+    if (m_redraw_frames > 0) return;
+
+    // 提前返回说明有输入或新日志，多绘制几帧；超时只刷新一帧
+    const auto wait_begin = clock::now();
+    WaitEvents(kIdleRedrawSeconds);
+    const bool woken = clock::now() - wait_begin < std::chrono::duration<double>(kIdleRedrawSeconds);
+    m_redraw_frames = woken ? kSettleFrames : 1;
+}
+
+void Manager::WaitEvents(double timeout_seconds) {
+#ifdef USE_WIN32_BACKEND
+    MsgWaitForMultipleObjects(0, nullptr, FALSE, static_cast<DWORD>(timeout_seconds * 1000.0), QS_ALLINPUT);
+#else
+    glfwWaitEventsTimeout(timeout_seconds);
+#endif
+}
+
+bool Manager::IsMainWindowFocused() const {
+#ifdef USE_WIN32_BACKEND
+    return GetForegroundWindow() == m_hwnd;
+#else
+    return glfwGetWindowAttrib(m_window, GLFW_FOCUSED) != 0;
+#endif
+}
+
+bool Manager::IsMainWindowMinimized() const {
+#ifdef USE_WIN32_BACKEND
+    return IsIconic(m_hwnd) != FALSE;
+#else
+    return glfwGetWindowAttrib(m_window, GLFW_ICONIFIED) != 0;
+#endif
+}
+
 bool Manager::ShouldExit() const {
     return m_should_exit;
 }
@@ -1596,7 +2075,7 @@ void Manager::RenderColorThemeSettings() {
             1.0f
         );
         if (ImGui::ColorEdit3("错误日志", (float *) &errorColor)) {
-            m_app_state.log_colors.error_color = errorColor;
+            m_app_state.log_colors.error_color = ToLogColor(errorColor);
             m_app_state.settings_dirty = true;
         }
 
@@ -1608,7 +2087,7 @@ void Manager::RenderColorThemeSettings() {
             1.0f
         );
         if (ImGui::ColorEdit3("警告日志", (float *) &warnColor)) {
-            m_app_state.log_colors.warn_color = warnColor;
+            m_app_state.log_colors.warn_color = ToLogColor(warnColor);
             m_app_state.settings_dirty = true;
         }
 
@@ -1620,7 +2099,7 @@ void Manager::RenderColorThemeSettings() {
             1.0f
         );
         if (ImGui::ColorEdit3("信息日志", (float *) &infoColor)) {
-            m_app_state.log_colors.info_color = infoColor;
+            m_app_state.log_colors.info_color = ToLogColor(infoColor);
             m_app_state.settings_dirty = true;
         }
 
@@ -1632,7 +2111,7 @@ void Manager::RenderColorThemeSettings() {
             1.0f
         );
         if (ImGui::ColorEdit3("调试日志", (float *) &debugColor)) {
-            m_app_state.log_colors.debug_color = debugColor;
+            m_app_state.log_colors.debug_color = ToLogColor(debugColor);
             m_app_state.settings_dirty = true;
         }
 
@@ -1775,29 +2254,20 @@ void Manager::LoadSavedTheme() {
     }
 }
 
-ImVec4 Manager::GetCustomLogLevelColor(const std::string &log) {
+// 只是级别到颜色的映射，修改自定义颜色不需要重新识别已有的行
+ImVec4 Manager::GetCustomLogLevelColor(LogLevel level) {
     if (!m_app_state.use_custom_log_colors) {
         // 使用默认颜色
-        return GetLogLevelColor(log);
+        return GetLogLevelColor(level);
     }
 
     // 使用自定义颜色
-    if (log.find("错误") != std::string::npos || log.find("[E]") != std::string::npos ||
-        log.find("[ERROR]") != std::string::npos || log.find("error") != std::string::npos) {
-        return m_app_state.log_colors.error_color;
-    } else if (log.find("警告") != std::string::npos || log.find("[W]") != std::string::npos ||
-               log.find("[WARN]") != std::string::npos || log.find("warning") != std::string::npos) {
-        return m_app_state.log_colors.warn_color;
-    } else if (log.find("信息") != std::string::npos || log.find("[I]") != std::string::npos ||
-               log.find("[INFO]") != std::string::npos || log.find("info") != std::string::npos) {
-        return m_app_state.log_colors.info_color;
-    } else if (log.find("调试") != std::string::npos || log.find("[D]") != std::string::npos ||
-               log.find("[DEBUG]") != std::string::npos || log.find("debug") != std::string::npos) {
-        return m_app_state.log_colors.debug_color;
-    } else if (log.find("跟踪") != std::string::npos || log.find("[T]") != std::string::npos ||
-               log.find("[TRACE]") != std::string::npos || log.find("trace") != std::string::npos) {
-        return m_app_state.log_colors.trace_color;
-    }
-
-    return ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // 默认白色
+    switch (level) {
+        case LogLevel::Error: return ToImVec4(m_app_state.log_colors.error_color);
+        case LogLevel::Warn:  return ToImVec4(m_app_state.log_colors.warn_color);
+        case LogLevel::Info:  return ToImVec4(m_app_state.log_colors.info_color);
+        case LogLevel::Debug: return ToImVec4(m_app_state.log_colors.debug_color);
+        case LogLevel::Trace: return ToImVec4(m_app_state.log_colors.trace_color);
+        default:              return ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // 默认白色
+    }
 }
@@ -0,0 +1,20 @@
+#include "PerfCounters.h"
+
+PerfCounters::Sample PerfCounters::Load() const {
+    Sample sample;
+    sample.time_ns = PerfNowNs();
+    sample.read_bytes = read_bytes.load(std::memory_order_relaxed);
+    sample.read_lines = read_lines.load(std::memory_order_relaxed);
+    sample.conversion_ns = conversion_ns.load(std::memory_order_relaxed);
+    sample.ansi_ns = ansi_ns.load(std::memory_order_relaxed);
+    sample.level_ns = level_ns.load(std::memory_order_relaxed);
+    sample.logs_lock_wait_ns = logs_lock_wait_ns.load(std::memory_order_relaxed);
+    sample.frames = frames.load(std::memory_order_relaxed);
+    sample.frame_ns = frame_ns.load(std::memory_order_relaxed);
+    return sample;
+}
+
+PerfCounters& PerfCounters::Global() {
+    static PerfCounters counters;
+    return counters;
+}
@@ -0,0 +1,114 @@
+#include "StreamDecoder.h"
+#include "Utf8.h"
+
+namespace {
+    inline bool InRange(unsigned char b, unsigned char lo, unsigned char hi) {
+        return b >= lo && b <= hi;
+    }
+}
+
+StreamDecoder::Piece StreamDecoder::Take(std::string_view chunk, OutputEncoding requested) {
+    std::string_view data = chunk;
+    if (!carry_.empty()) {
+        joined_.assign(carry_);
+        joined_.append(chunk.data(), chunk.size());
+        carry_.clear();
+        data = joined_;
+    }
+
+    const OutputEncoding encoding =
+        requested == OutputEncoding::AUTO_DETECT ? detector_.Resolve(data) : requested;
+    const size_t complete = CompleteLength(data, encoding);
+
+    carry_.assign(data.data() + complete, data.size() - complete);
+    last_encoding_ = encoding;
+    return {data.substr(0, complete), encoding};
+}
+
+StreamDecoder::Piece StreamDecoder::Flush() {
+    joined_.swap(carry_);
+    carry_.clear();
+    return {joined_, last_encoding_};
+}
+
+void StreamDecoder::Reset() {
+    carry_.clear();
+    joined_.clear();
+    detector_.Reset();
+    last_encoding_ = OutputEncoding::UTF8;
+}
+
+// 从块首(总是字符边界)向前扫描，返回最后一个完整字符之后的位置
+size_t StreamDecoder::CompleteLength(std::string_view data, OutputEncoding encoding) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    const size_t len = data.size();
+    size_t i = 0;
+
+    switch (encoding) {
+        case OutputEncoding::UTF8:
+            return len - Utf8IncompleteTail(data);
+#ifdef _WIN32
+        case OutputEncoding::GBK:
+        case OutputEncoding::GB2312:
+        case OutputEncoding::BIG5:
+            while (i < len) {
+                if (InRange(bytes[i], 0x81, 0xFE)) {
+                    if (i + 1 >= len) return i;
+                    i += 2;
+                } else {
+                    ++i;
+                }
+            }
+            return len;
+        case OutputEncoding::SHIFT_JIS:
+            while (i < len) {
+                if (InRange(bytes[i], 0x81, 0x9F) || InRange(bytes[i], 0xE0, 0xFC)) {
+                    if (i + 1 >= len) return i;
+                    i += 2;
+                } else {
+                    ++i;
+                }
+            }
+            return len;
+#else
+        case OutputEncoding::GB18030:
+            while (i < len) {
+                if (InRange(bytes[i], 0x81, 0xFE)) {
+                    if (i + 1 >= len) return i;
+                    // 第二字节为数字时是四字节序列
+                    if (InRange(bytes[i + 1], 0x30, 0x39)) {
+                        if (i + 3 >= len) return i;
+                        i += 4;
+                    } else {
+                        i += 2;
+                    }
+                } else {
+                    ++i;
+                }
+            }
+            return len;
+        case OutputEncoding::BIG5:
+            while (i < len) {
+                if (InRange(bytes[i], 0x81, 0xFE)) {
+                    if (i + 1 >= len) return i;
+                    i += 2;
+                } else {
+                    ++i;
+                }
+            }
+            return len;
+        case OutputEncoding::EUC_JP:
+            while (i < len) {
+                size_t width = 1;
+                if (bytes[i] == 0x8F) width = 3;
+                else if (bytes[i] == 0x8E || InRange(bytes[i], 0xA1, 0xFE)) width = 2;
+                if (i + width > len) return i;
+                i += width;
+            }
+            return len;
+        case OutputEncoding::ISO_8859_1:
+#endif
+        default:
+            return len;
+    }
+}
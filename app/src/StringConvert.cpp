@@ -0,0 +1,84 @@
+#include "StringConvert.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+std::wstring StringToWide(const std::string &str) {
+    if (str.empty()) return L"";
+    int size = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+    std::wstring wstr(size, 0);
+    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &wstr[0], size);
+    return wstr;
+}
+
+std::string WideToString(const std::wstring &wstr) {
+    if (wstr.empty()) return "";
+    int size = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, nullptr, 0, nullptr, nullptr);
+    std::string str(size, 0);
+    WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &str[0], size, nullptr, nullptr);
+    return str;
+}
+
+#else
+
+// 不依赖locale的UTF-8编解码，无效字节替换为U+FFFD
+std::wstring StringToWide(const std::string &str) {
+    std::wstring wstr;
+    wstr.reserve(str.size());
+    const auto *p = reinterpret_cast<const unsigned char *>(str.data());
+    const auto *const end = p + str.size();
+    while (p < end) {
+        const unsigned char lead = *p;
+        int extra = lead < 0x80 ? 0 : (lead >> 5) == 0x06 ? 1 : (lead >> 4) == 0x0E ? 2 : (lead >> 3) == 0x1E ? 3 : -1;
+        if (extra < 0 || end - p <= extra) {
+            wstr.push_back(L'\xFFFD');
+            ++p;
+            continue;
+        }
+        char32_t code = extra == 0 ? lead : lead & (0x3F >> extra);
+        bool valid = true;
+        for (int i = 1; i <= extra; ++i) {
+            if ((p[i] & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            code = (code << 6) | (p[i] & 0x3F);
+        }
+        if (!valid) {
+            wstr.push_back(L'\xFFFD');
+            ++p;
+            continue;
+        }
+        wstr.push_back(static_cast<wchar_t>(code));
+        p += extra + 1;
+    }
+    return wstr;
+}
+
+std::string WideToString(const std::wstring &wstr) {
+    std::string str;
+    str.reserve(wstr.size());
+    for (wchar_t wc : wstr) {
+        const auto code = static_cast<char32_t>(wc);
+        if (code < 0x80) {
+            str.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            str.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            str.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x110000) {
+            str.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            str.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            str.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            str.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            str += "\xEF\xBF\xBD";
+        }
+    }
+    return str;
+}
+
+#endif
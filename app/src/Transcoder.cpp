@@ -0,0 +1,230 @@
+#include "Transcoder.h"
+#include "TranscodeTables.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define TRANSCODER_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace transcode_tables;
+
+namespace {
+    enum class Kind {
+        Gbk,        // CP936：双字节 + 0x80(欧元符号)，与GB18030的双字节区并不完全相同
+        Gb18030,    // 双字节 + 四字节
+        Big5,
+        ShiftJis,
+        Latin1,
+        Unsupported,
+    };
+
+    Kind KindOf(OutputEncoding encoding) {
+        switch (encoding) {
+#ifdef _WIN32
+            case OutputEncoding::GBK: return Kind::Gbk;
+            case OutputEncoding::BIG5: return Kind::Big5;
+            case OutputEncoding::SHIFT_JIS: return Kind::ShiftJis;
+#else
+            case OutputEncoding::GB18030: return Kind::Gb18030;
+            case OutputEncoding::BIG5: return Kind::Big5;
+            case OutputEncoding::ISO_8859_1: return Kind::Latin1;
+#endif
+            default: return Kind::Unsupported;
+        }
+    }
+
+    inline char* PutUtf8(char* out, uint32_t cp) {
+        if (cp < 0x80) {
+            *out++ = static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (cp >> 6));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (cp >> 12));
+            *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            *out++ = static_cast<char>(0xF0 | (cp >> 18));
+            *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        return out;
+    }
+
+    inline unsigned CountTrailingZeros(unsigned mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    // 复制从p开始的ASCII连续段，返回复制的字节数
+    // 整块复制可能多写最多15字节到out之后，调用方保证缓冲区留有余量(后续输出会覆盖它们)
+    inline size_t CopyAscii(const unsigned char* p, const unsigned char* end, char* out) {
+        const unsigned char* const begin = p;
+#ifdef TRANSCODER_SSE2
+        while (end - p >= 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(v));
+            if (mask != 0) {
+                return static_cast<size_t>(p - begin) + CountTrailingZeros(mask);
+            }
+            p += 16;
+            out += 16;
+        }
+#else
+        while (end - p >= 8) {
+            uint64_t v;
+            memcpy(&v, p, 8);
+            if (v & 0x8080808080808080ull) break;
+            memcpy(out, &v, 8);
+            p += 8;
+            out += 8;
+        }
+#endif
+        while (p < end && *p < 0x80) *out++ = static_cast<char>(*p++);
+        return static_cast<size_t>(p - begin);
+    }
+
+    inline uint32_t LookupTwoByte(const uint16_t* table, unsigned lead_index, unsigned char trail) {
+        return table[lead_index * kTrailCount + (trail - kTrailBegin)];
+    }
+
+    inline bool IsGbDigit(unsigned char b) { return b >= 0x30 && b <= 0x39; }
+    inline bool IsGbLead(unsigned char b) { return b >= 0x81 && b <= 0xFE; }
+
+    // GB18030四字节序列对应的码点，未定义返回0
+    uint32_t DecodeGb18030FourByte(const unsigned char* p) {
+        const uint32_t linear = ((static_cast<uint32_t>(p[0] - 0x81) * 10 + (p[1] - 0x30)) * 126 + (p[2] - 0x81)) * 10 + (p[3] - 0x30);
+        if (p[0] <= 0x84) {
+            const auto* const end = kGb18030Ranges + std::size(kGb18030Ranges);
+            const auto* it = std::upper_bound(kGb18030Ranges, end, linear,
+                                              [](uint32_t value, const Gb18030Range& r) { return value < r.index; });
+            if (it == kGb18030Ranges) return 0;
+            --it;
+            return linear - it->index < it->length ? it->code_point + (linear - it->index) : 0;
+        }
+        if (p[0] >= 0x90 && p[0] <= 0xE3) {
+            // 辅助平面从0x90308130开始线性排列
+            const uint32_t cp = 0x10000 + linear - ((0x90 - 0x81) * 10 * 126 * 10);
+            return cp <= 0x10FFFF ? cp : 0;
+        }
+        return 0;
+    }
+
+    constexpr uint32_t kReplacement = 0xFFFD;
+
+    uint32_t LookupGb18030Supplementary(unsigned char lead, unsigned char trail) {
+        const uint16_t code = static_cast<uint16_t>((lead << 8) | trail);
+        for (const auto& entry : kGb18030TwoByteSupplementary) {
+            if (entry.code == code) return entry.code_point;
+        }
+        return 0;
+    }
+
+    // 解码一个以非ASCII字节开头的字符，返回消耗的字节数(至少为1)
+    template<Kind K>
+    inline size_t DecodeOne(const unsigned char* p, size_t left, uint32_t& cp) {
+        const unsigned char lead = p[0];
+        cp = kReplacement;
+
+        if constexpr (K == Kind::Latin1) {
+            cp = lead;
+            return 1;
+        } else if constexpr (K == Kind::ShiftJis) {
+            const bool double_byte = (lead >= 0x81 && lead <= 0x9F) || (lead >= 0xE0 && lead <= 0xFC);
+            if (!double_byte) {
+                if (const uint16_t single = kShiftJisSingleByte[lead - 0x80]) cp = single;
+                return 1;
+            }
+            if (left < 2 || p[1] < kTrailBegin || p[1] == 0xFF) return 1;
+            const unsigned lead_index = lead <= 0x9F ? lead - 0x81 : lead - 0xE0 + 31;
+            if (const uint32_t mapped = LookupTwoByte(kShiftJisTwoByte, lead_index, p[1])) cp = mapped;
+            return 2;
+        } else {
+            if (!IsGbLead(lead)) {
+                // Windows代码页的单字节扩展：CP936为欧元符号和U+F8F5，CP950为U+0080和U+F8F8(glibc的BIG5同样接受0x80)
+                if constexpr (K == Kind::Gbk) {
+                    if (lead == 0x80) cp = 0x20AC;
+                    else if (lead == 0xFF) cp = 0xF8F5;
+                } else if constexpr (K == Kind::Big5) {
+                    if (lead == 0x80) cp = 0x80;
+                    else if (lead == 0xFF) cp = 0xF8F8;
+                }
+                return 1;
+            }
+            if (left < 2) return 1;
+            if constexpr (K == Kind::Gb18030) {
+                if (IsGbDigit(p[1])) {
+                    if (left < 4 || !IsGbLead(p[2]) || !IsGbDigit(p[3])) return 1;
+                    if (const uint32_t mapped = DecodeGb18030FourByte(p)) cp = mapped;
+                    return 4;
+                }
+            }
+            if (p[1] < kTrailBegin || p[1] == 0xFF) return 1;
+            const uint16_t* table = K == Kind::Big5 ? kBig5TwoByte : K == Kind::Gbk ? kGbkTwoByte : kGb18030TwoByte;
+            if (const uint32_t mapped = LookupTwoByte(table, lead - 0x81, p[1])) {
+                cp = mapped;
+            } else if constexpr (K == Kind::Gb18030) {
+                if (lead == 0xFE) {
+                    if (const uint32_t mapped = LookupGb18030Supplementary(lead, p[1])) cp = mapped;
+                }
+            }
+            return 2;
+        }
+    }
+
+    template<Kind K>
+    size_t Transcode(const unsigned char* p, const unsigned char* end, char* const out_begin) {
+        char* out = out_begin;
+        while (p < end) {
+            if (*p < 0x80) {
+                const size_t n = CopyAscii(p, end, out);
+                p += n;
+                out += n;
+                continue;
+            }
+            uint32_t cp;
+            p += DecodeOne<K>(p, static_cast<size_t>(end - p), cp);
+            out = PutUtf8(out, cp);
+        }
+        return static_cast<size_t>(out - out_begin);
+    }
+}
+
+bool CanTranscodeToUtf8(OutputEncoding encoding) {
+    return KindOf(encoding) != Kind::Unsupported;
+}
+
+std::string_view TranscodeToUtf8(std::string_view input, OutputEncoding encoding, std::string& buffer) {
+    // 每个输入字节最多产生3字节输出(单字节字符或无法解码时的U+FFFD)，另留整块复制的余量
+    const size_t worst_case = input.size() * 3 + 16;
+    if (buffer.size() < worst_case) buffer.resize(worst_case);
+
+    const auto* p = reinterpret_cast<const unsigned char*>(input.data());
+    const auto* end = p + input.size();
+    char* out = buffer.data();
+
+    size_t written;
+    switch (KindOf(encoding)) {
+        case Kind::Gbk: written = Transcode<Kind::Gbk>(p, end, out); break;
+        case Kind::Gb18030: written = Transcode<Kind::Gb18030>(p, end, out); break;
+        case Kind::Big5: written = Transcode<Kind::Big5>(p, end, out); break;
+        case Kind::ShiftJis: written = Transcode<Kind::ShiftJis>(p, end, out); break;
+        case Kind::Latin1: written = Transcode<Kind::Latin1>(p, end, out); break;
+        default: return {};
+    }
+    return {buffer.data(), written};
+}
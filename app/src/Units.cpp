@@ -1,26 +1,14 @@
 #include "Units.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <string>
 #include <vector>
 #include <mutex>
 #include <thread>
 #include <windows.h>
-#include <sstream>
 
-std::wstring StringToWide(const std::string &str) {
-    if (str.empty()) return L"";
-    int size = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
-    std::wstring wstr(size, 0);
-    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &wstr[0], size);
-    return wstr;
-}
-
-std::string WideToString(const std::wstring &wstr) {
-    if (wstr.empty()) return "";
-    int size = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, nullptr, 0, nullptr, nullptr);
-    std::string str(size, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &str[0], size, nullptr, nullptr);
-    return str;
-}
+#include "AnsiParser.h"
 
 void SetAutoStart(bool enable) {
     HKEY hKey;
@@ -78,284 +66,111 @@ bool IsAutoStartEnabled() {
     return exists;
 }
 
-// 日志颜色处理函数
-ImVec4 GetLogLevelColor(const std::string &log) {
-    // 简单的日志级别颜色区分
-    if (log.find("错误") != std::string::npos || log.find("[E]") != std::string::npos ||
-        log.find("[ERROR]") != std::string::npos || log.find("error") != std::string::npos) {
-        return ImVec4(1.0f, 0.4f, 0.4f, 1.0f); // 红色
-    } else if (log.find("警告") != std::string::npos || log.find("[W]") != std::string::npos ||
-               log.find("[WARN]") != std::string::npos || log.find("warning") != std::string::npos) {
-        return ImVec4(1.0f, 1.0f, 0.4f, 1.0f); // 黄色
-    } else if (log.find("信息") != std::string::npos || log.find("[I]") != std::string::npos ||
-               log.find("[INFO]") != std::string::npos || log.find("info") != std::string::npos) {
-        return ImVec4(0.4f, 1.0f, 0.4f, 1.0f); // 绿色
-    } else if (log.find("调试") != std::string::npos || log.find("[D]") != std::string::npos ||
-               log.find("[DEBUG]") != std::string::npos || log.find("debug") != std::string::npos) {
-        return ImVec4(0.6f, 0.6f, 1.0f, 1.0f); // 蓝色
-    } else if (log.find("跟踪") != std::string::npos || log.find("[T]") != std::string::npos ||
-               log.find("[TRACE]") != std::string::npos || log.find("trace") != std::string::npos) {
-        return ImVec4(0.8f, 0.8f, 0.8f, 1.0f); // 灰色
+// 日志级别的默认颜色，级别在入库时已识别(见LogLevel.h)
+ImVec4 GetLogLevelColor(LogLevel level) {
+    switch (level) {
+        case LogLevel::Error: return ImVec4(1.0f, 0.4f, 0.4f, 1.0f); // 红色
+        case LogLevel::Warn:  return ImVec4(1.0f, 1.0f, 0.4f, 1.0f); // 黄色
+        case LogLevel::Info:  return ImVec4(0.4f, 1.0f, 0.4f, 1.0f); // 绿色
+        case LogLevel::Debug: return ImVec4(0.6f, 0.6f, 1.0f, 1.0f); // 蓝色
+        case LogLevel::Trace: return ImVec4(0.8f, 0.8f, 0.8f, 1.0f); // 灰色
+        default:              return ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // 默认白色
     }
-    return ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // 默认白色
 }
 
-// ANSI颜色处理增强版本
-void RenderColoredLogLine(const std::string &log) {
-    auto segments = ParseAnsiColorCodes(log);
-
-    if (segments.empty()) {
-        // 如果没有ANSI代码，使用简单的日志级别颜色
-        ImVec4 textColor = GetLogLevelColor(log);
-        ImGui::TextColored(textColor, "%s", log.c_str());
-        return;
-    }
-
-    // 渲染带颜色的文本段
-    bool first = true;
-    for (const auto &segment: segments) {
-        if (!first) {
-            ImGui::SameLine(0, 0); // 在同一行继续显示
-        }
-        first = false;
-
-        if (!segment.text.empty()) {
-            ImGui::TextColored(segment.color, "%s", segment.text.c_str());
+// 颜色段在入库时已解析(见LogStore::Push)
+// 整行只占一个布局项：各段文字直接写入窗口的绘制列表，不再逐段创建TextColored控件并用SameLine拼接
+void RenderColoredLogLine(const LogLineView &line) {
+    ImDrawList *draw_list = ImGui::GetWindowDrawList();
+    ImFont *font = ImGui::GetFont();
+    const float font_size = ImGui::GetFontSize();
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float clip_right = draw_list->GetClipRectMax().x;
+    const ImU32 default_color = ImGui::GetColorU32(ImGuiCol_Text);
+    const char *text = line.text.data();
+
+    float x = origin.x;
+    auto draw_run = [&](size_t begin, size_t end, ImU32 color) {
+        if (begin == end) return;
+        // 超出可见区域右侧的段只需计入宽度(水平滚动条需要整行宽度)
+        if (x < clip_right) {
+            draw_list->AddText(font, font_size, ImVec2(x, origin.y), color, text + begin, text + end);
         }
-    }
-}
-
-
-std::vector<ColoredTextSegment> ParseAnsiColorCodes(const std::string &text) {
-    std::vector<ColoredTextSegment> segments;
+        x += font->CalcTextSizeA(font_size, FLT_MAX, 0.0f, text + begin, text + end).x;
+    };
 
-    if (text.empty()) {
-        return segments;
+    const size_t run_count = line.RunCount();
+    draw_run(0, run_count > 0 ? line.Run(0).offset : line.text.size(), default_color);
+    for (size_t i = 0; i < run_count; ++i) {
+        const LogColorRun run = line.Run(i);
+        draw_run(run.offset, line.RunEnd(i), run.color == kAnsiDefaultColor ? default_color : run.color);
     }
 
-    size_t pos = 0;
-    ImVec4 currentColor = ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // 默认白色
-    bool isBold = false;
-
-    while (pos < text.length()) {
-        size_t escapePos = text.find('\033', pos);
-
-        if (escapePos == std::string::npos) {
-            // 没有更多转义序列，添加剩余文本
-            if (pos < text.length()) {
-                segments.push_back({text.substr(pos), currentColor});
-            }
-            break;
-        }
-
-        // 添加转义序列之前的文本
-        if (escapePos > pos) {
-            segments.push_back({text.substr(pos, escapePos - pos), currentColor});
-        }
-
-        // 解析ANSI转义序列
-        size_t codeStart = escapePos + 1;
-        if (codeStart < text.length() && text[codeStart] == '[') {
-            size_t codeEnd = text.find('m', codeStart);
-            if (codeEnd != std::string::npos) {
-                std::string colorCode = text.substr(codeStart + 1, codeEnd - codeStart - 1);
-                auto newColor = ParseAnsiColorCode(colorCode, currentColor, isBold);
-                currentColor = newColor.first;
-                isBold = newColor.second;
-                pos = codeEnd + 1;
-            } else {
-                // 无效的转义序列，跳过
-                pos = codeStart;
-            }
-        } else {
-            // 无效的转义序列，跳过
-            pos = codeStart;
-        }
-    }
-
-    return segments;
+    ImGui::Dummy(ImVec2(x - origin.x, ImGui::GetTextLineHeight()));
 }
 
-std::pair<ImVec4, bool>
-ParseAnsiColorCode(const std::string &code, const ImVec4 &currentColor, bool currentBold) {
-    ImVec4 newColor = currentColor;
-    bool newBold = currentBold;
+float LogLineScroller::ScrollbarWidth() {
+    return ImGui::GetStyle().ScrollbarSize + ImGui::GetStyle().ItemSpacing.x;
+}
 
-    // 分割多个颜色代码(用分号分隔)
-    std::vector<int> codes;
-    std::stringstream ss(code);
-    std::string item;
+void LogLineScroller::ScrollTo(uint64_t row, float align) {
+    target_pending_ = true;
+    target_row_ = row;
+    target_align_ = align;
+}
 
-    while (std::getline(ss, item, ';')) {
-        if (!item.empty()) {
-            try {
-                codes.push_back(std::stoi(item));
-            } catch (const std::exception &) {
-                // 忽略无效的代码
-            }
+void LogLineScroller::Begin(uint64_t total_rows, bool follow_end) {
+    at_end_ = first_ >= MaxFirst();
+
+    // 只显示完整可见的行，内容高度不超过子窗口，子窗口本身不会出现纵向滚动
+    const float line_height = ImGui::GetTextLineHeightWithSpacing();
+    count_ = std::max(1, static_cast<int>(ImGui::GetContentRegionAvail().y / line_height));
+    total_ = total_rows;
+    const uint64_t max_first = MaxFirst();
+
+    // 本帧有跳转、滚轮或按键时以它们为准，否则停在末尾的列表继续跟随
+    const uint64_t before = first_;
+    bool moved = false;
+    if (target_pending_) {
+        target_pending_ = false;
+        moved = true;
+        const uint64_t row = total_rows > 0 ? std::min(target_row_, total_rows - 1) : 0;
+        const auto above = static_cast<uint64_t>(static_cast<float>(count_ - 1) * target_align_);
+        first_ = row > above ? row - above : 0;
+    } else if (ImGui::IsWindowHovered()) {
+        const ImGuiIO& io = ImGui::GetIO();
+        if (io.MouseWheel != 0.0f && !io.KeyShift) {
+            const auto lines = static_cast<uint64_t>(std::abs(io.MouseWheel) * kWheelLines + 0.5f);
+            first_ = io.MouseWheel > 0.0f ? (first_ > lines ? first_ - lines : 0) : first_ + lines;
+            moved = true;
+        }
+        // 纵向滚动已由这里接管，横向滚动(Shift+滚轮或触控板)仍交给子窗口
+        const float wheel_h = io.MouseWheelH != 0.0f ? io.MouseWheelH : (io.KeyShift ? io.MouseWheel : 0.0f);
+        if (wheel_h != 0.0f) {
+            ImGui::SetScrollX(ImGui::GetScrollX() - wheel_h * line_height * kWheelLines);
         }
     }
-
-    // 如果没有代码，默认为0(重置)
-    if (codes.empty()) {
-        codes.push_back(0);
+    if (ImGui::IsWindowFocused()) {
+        const auto page = static_cast<uint64_t>(count_ > 1 ? count_ - 1 : 1);
+        if (ImGui::IsKeyPressed(ImGuiKey_PageUp)) first_ = first_ > page ? first_ - page : 0;
+        if (ImGui::IsKeyPressed(ImGuiKey_PageDown)) first_ += page;
+        if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) first_ = first_ > 0 ? first_ - 1 : 0;
+        if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) ++first_;
+        if (ImGui::IsKeyPressed(ImGuiKey_Home)) first_ = 0;
+        if (ImGui::IsKeyPressed(ImGuiKey_End)) first_ = max_first;
+        moved = moved || first_ != before;
     }
-
-    for (int colorCode: codes) {
-        switch (colorCode) {
-            case 0: // 重置
-                newColor = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
-                newBold = false;
-                break;
-            case 1: // 粗体/亮色
-                newBold = true;
-                break;
-            case 22: // 正常强度
-                newBold = false;
-                break;
-
-            // 前景色 (30-37)
-            case 30:
-                newColor = GetAnsiColor(0, newBold);
-                break; // 黑色
-            case 31:
-                newColor = GetAnsiColor(1, newBold);
-                break; // 红色
-            case 32:
-                newColor = GetAnsiColor(2, newBold);
-                break; // 绿色
-            case 33:
-                newColor = GetAnsiColor(3, newBold);
-                break; // 黄色
-            case 34:
-                newColor = GetAnsiColor(4, newBold);
-                break; // 蓝色
-            case 35:
-                newColor = GetAnsiColor(5, newBold);
-                break; // 洋红
-            case 36:
-                newColor = GetAnsiColor(6, newBold);
-                break; // 青色
-            case 37:
-                newColor = GetAnsiColor(7, newBold);
-                break; // 白色
-            case 39:
-                newColor = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
-                break; // 默认前景色
-
-            // 亮色前景色 (90-97)
-            case 90:
-                newColor = GetAnsiColor(8, false);
-                break; // 亮黑色(灰色)
-            case 91:
-                newColor = GetAnsiColor(9, false);
-                break; // 亮红色
-            case 92:
-                newColor = GetAnsiColor(10, false);
-                break; // 亮绿色
-            case 93:
-                newColor = GetAnsiColor(11, false);
-                break; // 亮黄色
-            case 94:
-                newColor = GetAnsiColor(12, false);
-                break; // 亮蓝色
-            case 95:
-                newColor = GetAnsiColor(13, false);
-                break; // 亮洋红
-            case 96:
-                newColor = GetAnsiColor(14, false);
-                break; // 亮青色
-            case 97:
-                newColor = GetAnsiColor(15, false);
-                break; // 亮白色
-
-            // 增加对背景色的支持 (40-47, 100-107)
-            case 40:
-            case 41:
-            case 42:
-            case 43:
-            case 44:
-            case 45:
-            case 46:
-            case 47:
-            case 100:
-            case 101:
-            case 102:
-            case 103:
-            case 104:
-            case 105:
-            case 106:
-            case 107:
-                // 背景色暂时不处理，因为ImGui不容易实现背景色
-                break;
-
-            default:
-                // 处理256色和RGB色彩(38;5;n 和 38;2;r;g;b)
-                if (colorCode == 38 || colorCode == 48) {
-                    // 38=前景，48=背景
-                    // 检查是否是256色模式或RGB模式
-                    if (codes.size() > 1) {
-                        if (codes[1] == 5 && codes.size() > 2) {
-                            // 256色模式
-                            // 暂时不实现所有256色，仅处理基本的16色
-                            int colorIndex = codes[2];
-                            if (colorIndex >= 0 && colorIndex < 16) {
-                                newColor = GetAnsiColor(colorIndex, newBold);
-                            }
-                        } else if (codes[1] == 2 && codes.size() > 4) {
-                            // RGB模式
-                            // 处理RGB值
-                            float r = static_cast<float>(codes[2]) / 255.0f;
-                            float g = static_cast<float>(codes[3]) / 255.0f;
-                            float b = static_cast<float>(codes[4]) / 255.0f;
-                            newColor = ImVec4(r, g, b, 1.0f);
-                        }
-                    }
-                }
-                break;
-        }
+    if (!moved && follow_end && at_end_) {
+        first_ = max_first;
     }
-
-    return {newColor, newBold};
+    first_ = std::min(first_, max_first);
+    count_ = static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(count_), total_rows - first_));
 }
 
-ImVec4 GetAnsiColor(int colorIndex, bool bright) {
-    // ANSI标准颜色表
-    static const ImVec4 ansiColors[16] = {
-        // 标准颜色 (0-7)
-        ImVec4(0.0f, 0.0f, 0.0f, 1.0f), // 0: 黑色
-        ImVec4(0.8f, 0.0f, 0.0f, 1.0f), // 1: 红色
-        ImVec4(0.0f, 0.8f, 0.0f, 1.0f), // 2: 绿色
-        ImVec4(0.8f, 0.8f, 0.0f, 1.0f), // 3: 黄色
-        ImVec4(0.0f, 0.0f, 0.8f, 1.0f), // 4: 蓝色
-        ImVec4(0.8f, 0.0f, 0.8f, 1.0f), // 5: 洋红
-        ImVec4(0.0f, 0.8f, 0.8f, 1.0f), // 6: 青色
-        ImVec4(0.8f, 0.8f, 0.8f, 1.0f), // 7: 白色
-
-        // 亮色 (8-15)
-        ImVec4(0.5f, 0.5f, 0.5f, 1.0f), // 8: 亮黑色(灰色)
-        ImVec4(1.0f, 0.0f, 0.0f, 1.0f), // 9: 亮红色
-        ImVec4(0.0f, 1.0f, 0.0f, 1.0f), // 10: 亮绿色
-        ImVec4(1.0f, 1.0f, 0.0f, 1.0f), // 11: 亮黄色
-        ImVec4(0.0f, 0.0f, 1.0f, 1.0f), // 12: 亮蓝色
-        ImVec4(1.0f, 0.0f, 1.0f, 1.0f), // 13: 亮洋红
-        ImVec4(0.0f, 1.0f, 1.0f, 1.0f), // 14: 亮青色
-        ImVec4(1.0f, 1.0f, 1.0f, 1.0f), // 15: 亮白色
-    };
-
-    if (colorIndex >= 0 && colorIndex < 16) {
-        ImVec4 color = ansiColors[colorIndex];
-
-        // 如果是粗体且是标准颜色(0-7)，增加亮度
-        if (bright && colorIndex < 8) {
-            color.x = std::min(1.0f, color.x + 0.3f);
-            color.y = std::min(1.0f, color.y + 0.3f);
-            color.z = std::min(1.0f, color.z + 0.3f);
-        }
-
-        return color;
-    }
-
-    return ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // 默认白色
+// 位置条的上端为第0行；取值直接是64位首行号，不经过像素换算
+void LogLineScroller::DrawScrollbar(const char* id, float height) {
+    uint64_t max_first = MaxFirst();
+    const uint64_t min_first = 0;
+    ImGui::VSliderScalar(id, ImVec2(ImGui::GetStyle().ScrollbarSize, height), ImGuiDataType_U64, &first_,
+                         &max_first, &min_first, "");
 }
-
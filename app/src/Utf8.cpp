@@ -0,0 +1,255 @@
+#include "Utf8.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define UTF8_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define UTF8_TARGET_AVX2
+#else
+#define UTF8_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+    // 按RFC 3629第4节的字节序列表逐字符校验，返回校验到的位置，出错返回nullptr
+    // 序列超出end视为截断(出错)
+    const unsigned char* ValidateScalar(const unsigned char* p, const unsigned char* end, const unsigned char* stop) {
+        while (p < stop) {
+            const unsigned char b = *p;
+            if (b <= 0x7F) {
+                ++p;
+                continue;
+            }
+
+            size_t width;
+            unsigned char lo = 0x80, hi = 0xBF;     // 第二字节的取值范围
+            if (b >= 0xC2 && b <= 0xDF) {
+                width = 2;
+            } else if (b >= 0xE0 && b <= 0xEF) {
+                width = 3;
+                if (b == 0xE0) lo = 0xA0;           // 超长编码
+                else if (b == 0xED) hi = 0x9F;      // 代理区 U+D800..U+DFFF
+            } else if (b >= 0xF0 && b <= 0xF4) {
+                width = 4;
+                if (b == 0xF0) lo = 0x90;           // 超长编码
+                else if (b == 0xF4) hi = 0x8F;      // 大于U+10FFFF
+            } else {
+                return nullptr;                     // 孤立的后续字节、C0/C1、F5..FF
+            }
+
+            if (static_cast<size_t>(end - p) < width) return nullptr;
+            if (p[1] < lo || p[1] > hi) return nullptr;
+            for (size_t k = 2; k < width; ++k) {
+                if ((p[k] & 0xC0) != 0x80) return nullptr;
+            }
+            p += width;
+        }
+        return p;
+    }
+
+#ifdef UTF8_X86
+    // SSE2：每次检查32字节是否全为ASCII，遇到非ASCII块时由标量代码校验该块(可能越过块尾最多3字节)
+    bool ValidateSse2(const unsigned char* p, size_t len) {
+        const unsigned char* const end = p + len;
+        while (static_cast<size_t>(end - p) >= 32) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+            if (_mm_movemask_epi8(_mm_or_si128(a, b)) == 0) {
+                p += 32;
+                continue;
+            }
+            p = ValidateScalar(p, end, p + 32);
+            if (!p) return false;
+        }
+        return ValidateScalar(p, end, end) != nullptr;
+    }
+
+    // AVX2：查表法一次校验32字节
+    // 每个字节与前1~3个字节组成的(高4位, 低4位, 下一字节高4位)分别查表，三张表按位与后非零即为错误；
+    // 第3、4字节位置必须恰好是"两个连续后续字节"的情形。块尾的未完成序列由下一块(或结束时)检查
+    namespace avx2 {
+        constexpr uint8_t TOO_SHORT = 1 << 0;       // 首字节后面不是后续字节
+        constexpr uint8_t TOO_LONG = 1 << 1;        // ASCII后面跟后续字节
+        constexpr uint8_t OVERLONG_3 = 1 << 2;      // E0 80..9F
+        constexpr uint8_t TOO_LARGE = 1 << 3;       // F4 90..BF、F5..FF
+        constexpr uint8_t SURROGATE = 1 << 4;       // ED A0..BF
+        constexpr uint8_t OVERLONG_2 = 1 << 5;      // C0..C1
+        constexpr uint8_t TOO_LARGE_1000 = 1 << 6;  // F5..FF 80..8F
+        constexpr uint8_t OVERLONG_4 = 1 << 6;      // F0 80..8F
+        constexpr uint8_t TWO_CONTS = 1 << 7;       // 两个连续的后续字节
+        constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+        UTF8_TARGET_AVX2 inline __m256i Table(uint8_t t0, uint8_t t1, uint8_t t2, uint8_t t3,
+                                              uint8_t t4, uint8_t t5, uint8_t t6, uint8_t t7,
+                                              uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11,
+                                              uint8_t t12, uint8_t t13, uint8_t t14, uint8_t t15) {
+            return _mm256_setr_epi8(
+                static_cast<char>(t0), static_cast<char>(t1), static_cast<char>(t2), static_cast<char>(t3),
+                static_cast<char>(t4), static_cast<char>(t5), static_cast<char>(t6), static_cast<char>(t7),
+                static_cast<char>(t8), static_cast<char>(t9), static_cast<char>(t10), static_cast<char>(t11),
+                static_cast<char>(t12), static_cast<char>(t13), static_cast<char>(t14), static_cast<char>(t15),
+                static_cast<char>(t0), static_cast<char>(t1), static_cast<char>(t2), static_cast<char>(t3),
+                static_cast<char>(t4), static_cast<char>(t5), static_cast<char>(t6), static_cast<char>(t7),
+                static_cast<char>(t8), static_cast<char>(t9), static_cast<char>(t10), static_cast<char>(t11),
+                static_cast<char>(t12), static_cast<char>(t13), static_cast<char>(t14), static_cast<char>(t15));
+        }
+
+        UTF8_TARGET_AVX2 inline __m256i High4(__m256i v) {
+            return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+        }
+
+        // 当前块整体右移n字节，空出的位置由上一块末尾填充
+        template<int N>
+        UTF8_TARGET_AVX2 inline __m256i Prev(__m256i input, __m256i prev_input) {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+        }
+
+        struct State {
+            __m256i error;
+            __m256i prev_input;
+            __m256i prev_incomplete;
+        };
+
+        UTF8_TARGET_AVX2 inline void Check(State& s, __m256i input) {
+            if (_mm256_movemask_epi8(input) == 0) {
+                // 纯ASCII块：只需确认上一块没有以未完成序列结尾
+                s.error = _mm256_or_si256(s.error, s.prev_incomplete);
+                return;
+            }
+
+            const __m256i prev1 = Prev<1>(input, s.prev_input);
+            const __m256i byte_1_high = _mm256_shuffle_epi8(Table(
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                TOO_SHORT | OVERLONG_2,
+                TOO_SHORT,
+                TOO_SHORT | OVERLONG_3 | SURROGATE,
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4), High4(prev1));
+            const __m256i byte_1_low = _mm256_shuffle_epi8(Table(
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                CARRY | OVERLONG_2,
+                CARRY,
+                CARRY,
+                CARRY | TOO_LARGE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+            const __m256i byte_2_high = _mm256_shuffle_epi8(Table(
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT), High4(input));
+            const __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+            // 前2字节>=E0或前3字节>=F0的位置必须是后续字节，且此时TWO_CONTS是预期的
+            const __m256i is_third = _mm256_subs_epu8(Prev<2>(input, s.prev_input), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            const __m256i is_fourth = _mm256_subs_epu8(Prev<3>(input, s.prev_input), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            const __m256i must23 = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+            s.error = _mm256_or_si256(s.error, _mm256_xor_si256(must23, special));
+
+            // 块尾3字节中出现需要更多字节的首字节
+            const __m256i max_value = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+            s.prev_incomplete = _mm256_subs_epu8(input, max_value);
+            s.prev_input = input;
+        }
+    }
+
+    UTF8_TARGET_AVX2 bool ValidateAvx2(const unsigned char* p, size_t len) {
+        avx2::State state;
+        state.error = _mm256_setzero_si256();
+        state.prev_input = _mm256_setzero_si256();
+        state.prev_incomplete = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 32 <= len; i += 32) {
+            avx2::Check(state, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+        }
+        if (i < len) {
+            // 尾部补零(ASCII)后按整块处理，截断的序列会在补零处报错
+            alignas(32) unsigned char tail[32] = {};
+            memcpy(tail, p + i, len - i);
+            avx2::Check(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+        }
+        const __m256i error = _mm256_or_si256(state.error, state.prev_incomplete);
+        return _mm256_testz_si256(error, error) != 0;
+    }
+
+    bool CpuHasAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        // 操作系统需保存YMM寄存器状态
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    using ValidateFn = bool (*)(const unsigned char*, size_t);
+
+    bool ValidateScalarAll(const unsigned char* p, size_t len) {
+        return ValidateScalar(p, p + len, p + len) != nullptr;
+    }
+
+    ValidateFn SelectValidator() {
+#ifdef UTF8_X86
+        if (CpuHasAvx2()) return ValidateAvx2;
+        // x86-64上SSE2总是可用；32位x86也按SSE2处理(Windows 8起已是最低要求)
+        return ValidateSse2;
+#else
+        return ValidateScalarAll;
+#endif
+    }
+}
+
+bool IsValidUTF8(std::string_view str) {
+    static const ValidateFn validate = SelectValidator();
+    return validate(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+}
+
+bool IsValidUTF8Scalar(std::string_view str) {
+    return ValidateScalarAll(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+}
+
+// 从末尾向前最多看3个字节，找到最后一个首字节并比较其声明的长度
+size_t Utf8IncompleteTail(std::string_view str) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(str.data());
+    const size_t len = str.size();
+
+    for (size_t k = 1; k <= 3 && k <= len; ++k) {
+        const unsigned char b = bytes[len - k];
+        if ((b & 0xC0) == 0x80) continue;   // 后续字节
+
+        size_t needed = 1;
+        if (b >= 0xF0) needed = 4;
+        else if (b >= 0xE0) needed = 3;
+        else if (b >= 0xC0) needed = 2;
+        return needed > k ? k : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "OutputEncoding.h"
+
+// climanager_core基准测试的公共设施：规模、计时、语料生成、系统转换接口对照和分配计数
+// 各项测试对应积压需求中要求的度量，结果以表格打印到标准输出
+
+struct BenchOptions {
+    bool quick = false;     // --quick：缩小规模，供ctest冒烟运行
+};
+
+// --quick时规模缩小为1/16(至少为1)
+size_t BenchScale(size_t full, const BenchOptions& options);
+
+// 进程启动以来operator new的调用次数(由BenchMain.cpp中替换的全局operator new计数)
+uint64_t BenchAllocations();
+// 通过operator new分配、尚未释放的字节数(按请求大小计，不含分配器自身的开销)
+uint64_t BenchLiveBytes();
+
+// 防止被测结果被优化掉
+void BenchKeep(uint64_t value);
+
+double MegabytesPerSecond(size_t bytes, uint64_t ns);
+
+enum class CorpusKind {
+    Ascii,      // 纯ASCII日志
+    Cjk,        // 以中日文为主
+    Mixed,      // 英文与中日文混排，约三分之一为多字节字符
+    Japanese,   // 英文与假名、汉字混排，只能转换到日文编码
+};
+
+// 生成约bytes字节的UTF-8日志文本，按行以\n结尾，内容只由kind和seed决定。
+// 除Japanese外，多字节字符取自GBK、Big5、Shift-JIS和EUC-JP共有的字符，可以无损转换到各候选编码
+std::string MakeUtf8Corpus(CorpusKind kind, size_t bytes, uint32_t seed = 1);
+
+// 系统转换接口(Windows为MultiByteToWideChar/WideCharToMultiByte，其他平台为iconv)，
+// 用于把语料转换到目标编码，以及作为内置转换表的对照组
+bool SystemFromUtf8(std::string_view utf8, OutputEncoding encoding, std::string& out);
+bool SystemToUtf8(std::string_view input, OutputEncoding encoding, std::string& out);
+
+void RunLogStoreBench(const BenchOptions& options);     // user-002 环形存储每行写入成本
+void RunIngestBench(const BenchOptions& options);       // user-004 入库吞吐、每行开销与分配次数
+void RunFileSinkBench(const BenchOptions& options);     // user-007 日志文件写入吞吐
+void RunUtf8Bench(const BenchOptions& options);         // user-013 UTF-8校验
+void RunDetectorBench(const BenchOptions& options);     // user-014 编码检测每MB耗时
+void RunTranscoderBench(const BenchOptions& options);   // user-016 内置转换表与系统接口对比
+
+#endif // BENCH_H
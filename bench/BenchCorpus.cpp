@@ -0,0 +1,182 @@
+#include "Bench.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <iconv.h>
+#endif
+
+namespace {
+    // GBK、Big5、Shift-JIS和EUC-JP都能表示的常用汉字(UTF-8中均为3字节)
+    constexpr std::string_view kCjkChars =
+        "的一是在不了有和人中大上我以要他用生到作地出就分成可主年同工也能下子方多定行法所民得十三之等部度家"
+        "力如水化高自二理起小物加都日本時間月前後最新開始完正常接設";
+
+    // 平假名あ-ん
+    constexpr uint32_t kHiraganaFirst = 0x3042;
+    constexpr uint32_t kHiraganaCount = 0x3093 - 0x3042 + 1;
+
+    constexpr std::string_view kWords[] = {
+        "server", "request", "connected", "worker", "cache", "timeout", "retry", "GET", "/api/v1/items",
+        "status=200", "latency=12ms", "user_id=42", "shutdown", "listening", "port", "8080", "ok", "done",
+    };
+
+    constexpr std::string_view kLevels[] = {"[INFO]", "[DEBUG]", "[WARN]", "[ERROR]", "[TRACE]"};
+
+    struct Rng {
+        uint32_t state;
+        uint32_t Next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t Below(uint32_t n) { return Next() % n; }
+    };
+
+    void AppendCjk(std::string& out, Rng& rng, uint32_t count) {
+        const uint32_t chars = static_cast<uint32_t>(kCjkChars.size() / 3);
+        for (uint32_t i = 0; i < count; ++i) {
+            out.append(kCjkChars.substr(rng.Below(chars) * 3, 3));
+        }
+    }
+
+    void AppendKana(std::string& out, Rng& rng, uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t cp = kHiraganaFirst + rng.Below(kHiraganaCount);
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    void AppendWord(std::string& out, Rng& rng) {
+        out.append(kWords[rng.Below(sizeof(kWords) / sizeof(kWords[0]))]);
+    }
+
+#ifdef _WIN32
+    UINT CodePageOf(OutputEncoding encoding) {
+        switch (encoding) {
+            case OutputEncoding::UTF8: return CP_UTF8;
+            case OutputEncoding::GBK: return 936;
+            case OutputEncoding::GB2312: return 20936;
+            case OutputEncoding::BIG5: return 950;
+            case OutputEncoding::SHIFT_JIS: return 932;
+            default: return 0;
+        }
+    }
+
+    bool Convert(std::string_view input, UINT from, UINT to, std::string& out) {
+        out.clear();
+        if (input.empty()) return true;
+        if (from == 0 || to == 0) return false;
+        const int wide_size = MultiByteToWideChar(from, 0, input.data(), static_cast<int>(input.size()), nullptr, 0);
+        if (wide_size <= 0) return false;
+        std::wstring wide(static_cast<size_t>(wide_size), L'\0');
+        MultiByteToWideChar(from, 0, input.data(), static_cast<int>(input.size()), wide.data(), wide_size);
+        const int size = WideCharToMultiByte(to, 0, wide.data(), wide_size, nullptr, 0, nullptr, nullptr);
+        if (size <= 0) return false;
+        out.resize(static_cast<size_t>(size));
+        WideCharToMultiByte(to, 0, wide.data(), wide_size, out.data(), size, nullptr, nullptr);
+        return true;
+    }
+#else
+    const char* IconvNameOf(OutputEncoding encoding) {
+        switch (encoding) {
+            case OutputEncoding::UTF8: return "UTF-8";
+            case OutputEncoding::ISO_8859_1: return "ISO-8859-1";
+            case OutputEncoding::GB18030: return "GB18030";
+            case OutputEncoding::BIG5: return "BIG5";
+            case OutputEncoding::EUC_JP: return "EUC-JP";
+            default: return nullptr;
+        }
+    }
+
+    bool Convert(std::string_view input, const char* from, const char* to, std::string& out) {
+        out.clear();
+        if (!from || !to) return false;
+        iconv_t cd = iconv_open(to, from);
+        if (cd == reinterpret_cast<iconv_t>(-1)) return false;
+
+        out.resize(input.size() * 4 + 16);
+        char* in_ptr = const_cast<char*>(input.data());
+        size_t in_left = input.size();
+        char* out_ptr = out.data();
+        size_t out_left = out.size();
+        const bool ok = iconv(cd, &in_ptr, &in_left, &out_ptr, &out_left) != static_cast<size_t>(-1);
+        iconv_close(cd);
+        out.resize(out.size() - out_left);
+        return ok;
+    }
+#endif
+}
+
+std::string MakeUtf8Corpus(CorpusKind kind, size_t bytes, uint32_t seed) {
+    std::string out;
+    out.reserve(bytes + 256);
+    Rng rng{seed * 2654435761u + 1};
+    uint32_t line = 0;
+
+    while (out.size() < bytes) {
+        switch (kind) {
+            case CorpusKind::Ascii:
+                out.append("2024-05-01 12:00:");
+                out.append(std::to_string(10 + line % 50));
+                out += ' ';
+                out.append(kLevels[rng.Below(5)]);
+                for (uint32_t w = 3 + rng.Below(10); w > 0; --w) {
+                    out += ' ';
+                    AppendWord(out, rng);
+                }
+                break;
+            case CorpusKind::Cjk:
+                for (uint32_t w = 2 + rng.Below(4); w > 0; --w) {
+                    AppendCjk(out, rng, 4 + rng.Below(12));
+                    out.append("\xE3\x80\x82");     // 。
+                }
+                break;
+            case CorpusKind::Mixed:
+                out.append(kLevels[rng.Below(5)]);
+                for (uint32_t w = 4 + rng.Below(8); w > 0; --w) {
+                    out += ' ';
+                    if (rng.Below(3) == 0) {
+                        AppendCjk(out, rng, 2 + rng.Below(6));
+                    } else {
+                        AppendWord(out, rng);
+                    }
+                }
+                break;
+            case CorpusKind::Japanese:
+                out.append(kLevels[rng.Below(5)]);
+                for (uint32_t w = 4 + rng.Below(8); w > 0; --w) {
+                    out += ' ';
+                    if (rng.Below(2) == 0) {
+                        AppendCjk(out, rng, 1 + rng.Below(3));
+                        AppendKana(out, rng, 2 + rng.Below(5));
+                    } else {
+                        AppendWord(out, rng);
+                    }
+                }
+                break;
+        }
+        out += '\n';
+        ++line;
+    }
+    return out;
+}
+
+bool SystemFromUtf8(std::string_view utf8, OutputEncoding encoding, std::string& out) {
+#ifdef _WIN32
+    return Convert(utf8, CP_UTF8, CodePageOf(encoding), out);
+#else
+    return Convert(utf8, "UTF-8", IconvNameOf(encoding), out);
+#endif
+}
+
+bool SystemToUtf8(std::string_view input, OutputEncoding encoding, std::string& out) {
+#ifdef _WIN32
+    return Convert(input, CodePageOf(encoding), CP_UTF8, out);
+#else
+    return Convert(input, IconvNameOf(encoding), "UTF-8", out);
+#endif
+}
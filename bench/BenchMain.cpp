@@ -0,0 +1,121 @@
+#include "Bench.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// 替换全局operator new以统计分配次数(user-004要求报告每行分配次数)和当前仍在使用的堆字节数。
+// 每块分配前面留一个头部记录请求的大小，释放时据此扣除
+namespace {
+    std::atomic<uint64_t> g_allocations{0};
+    std::atomic<uint64_t> g_live_bytes{0};
+    volatile uint64_t g_sink = 0;
+
+    constexpr size_t kHeader = alignof(std::max_align_t);
+
+    void* CountedAlloc(size_t size) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (auto* p = static_cast<unsigned char*>(std::malloc(size + kHeader))) {
+            memcpy(p, &size, sizeof(size));
+            g_live_bytes.fetch_add(size, std::memory_order_relaxed);
+            return p + kHeader;
+        }
+        throw std::bad_alloc();
+    }
+
+    void CountedFree(void* p) noexcept {
+        if (!p) return;
+        auto* block = static_cast<unsigned char*>(p) - kHeader;
+        size_t size;
+        memcpy(&size, block, sizeof(size));
+        g_live_bytes.fetch_sub(size, std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, size_t) noexcept { CountedFree(p); }
+
+uint64_t BenchLiveBytes() {
+    return g_live_bytes.load(std::memory_order_relaxed);
+}
+
+uint64_t BenchAllocations() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+void BenchKeep(uint64_t value) {
+    g_sink = g_sink + value;
+}
+
+size_t BenchScale(size_t full, const BenchOptions& options) {
+    if (!options.quick) return full;
+    return full / 16 > 0 ? full / 16 : 1;
+}
+
+double MegabytesPerSecond(size_t bytes, uint64_t ns) {
+    if (ns == 0) return 0.0;
+    return static_cast<double>(bytes) / (1024.0 * 1024.0) / (static_cast<double>(ns) / 1e9);
+}
+
+namespace {
+    struct Suite {
+        const char* name;
+        const char* title;
+        void (*run)(const BenchOptions&);
+    };
+
+    constexpr Suite kSuites[] = {
+        {"logstore", "环形日志存储：每行写入成本随保留行数的变化 (user-002)", RunLogStoreBench},
+        {"ingest", "入库吞吐：分行 + 解析 + 存储 (user-004)", RunIngestBench},
+        {"sink", "日志文件写入吞吐 (user-007)", RunFileSinkBench},
+        {"utf8", "UTF-8校验 (user-013)", RunUtf8Bench},
+        {"detect", "自动检测编码耗时 (user-014)", RunDetectorBench},
+        {"transcode", "转换到UTF-8：内置转换表与系统接口 (user-016)", RunTranscoderBench},
+    };
+
+    void PrintUsage() {
+        std::printf("用法: climanager_bench [--quick] [测试名...]\n可选测试:");
+        for (const Suite& suite : kSuites) std::printf(" %s", suite.name);
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    bool selected[sizeof(kSuites) / sizeof(kSuites[0])] = {};
+    bool any_selected = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+            continue;
+        }
+        bool known = false;
+        for (size_t s = 0; s < sizeof(kSuites) / sizeof(kSuites[0]); ++s) {
+            if (std::strcmp(argv[i], kSuites[s].name) == 0) {
+                selected[s] = true;
+                any_selected = known = true;
+            }
+        }
+        if (!known) {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    for (size_t s = 0; s < sizeof(kSuites) / sizeof(kSuites[0]); ++s) {
+        if (any_selected && !selected[s]) continue;
+        std::printf("\n== %s ==\n", kSuites[s].title);
+        kSuites[s].run(options);
+        std::fflush(stdout);
+    }
+    return 0;
+}
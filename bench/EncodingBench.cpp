@@ -0,0 +1,194 @@
+#include "Bench.h"
+#include "CLIProcess.h"
+#include "EncodingDetector.h"
+#include "PerfCounters.h"
+#include "Transcoder.h"
+#include "Utf8.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+    constexpr size_t kChunkSize = 4096;     // 与管道读取块一致
+
+#ifdef _WIN32
+    constexpr OutputEncoding kMultiByteEncodings[] = {
+        OutputEncoding::GBK, OutputEncoding::BIG5, OutputEncoding::SHIFT_JIS};
+#else
+    constexpr OutputEncoding kMultiByteEncodings[] = {
+        OutputEncoding::GB18030, OutputEncoding::BIG5, OutputEncoding::EUC_JP};
+#endif
+
+    bool IsJapanese(OutputEncoding encoding) {
+#ifdef _WIN32
+        return encoding == OutputEncoding::SHIFT_JIS;
+#else
+        return encoding == OutputEncoding::EUC_JP;
+#endif
+    }
+
+    const char* CorpusName(CorpusKind kind) {
+        switch (kind) {
+            case CorpusKind::Ascii: return "ASCII";
+            case CorpusKind::Cjk: return "中日文";
+            case CorpusKind::Mixed: return "混合";
+            case CorpusKind::Japanese: return "日文";
+        }
+        return "";
+    }
+
+    // 原CLIProcess::IsValidUTF8的逐字节实现，照搬作为对照：只检查续字节的形式，不拒绝过长编码、代理区和超出U+10FFFF的码点，
+    // 因此比现在的严格标量校验(IsValidUTF8Scalar)做的事少，两者都列出
+    bool OriginalIsValidUTF8(std::string_view str) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(str.data());
+        const size_t len = str.size();
+        for (size_t i = 0; i < len;) {
+            if (bytes[i] <= 0x7F) {
+                i++;
+            } else if ((bytes[i] & 0xE0) == 0xC0) {
+                if (i + 1 >= len || (bytes[i + 1] & 0xC0) != 0x80) return false;
+                i += 2;
+            } else if ((bytes[i] & 0xF0) == 0xE0) {
+                if (i + 2 >= len || (bytes[i + 1] & 0xC0) != 0x80 || (bytes[i + 2] & 0xC0) != 0x80) return false;
+                i += 3;
+            } else if ((bytes[i] & 0xF8) == 0xF0) {
+                if (i + 3 >= len || (bytes[i + 1] & 0xC0) != 0x80 || (bytes[i + 2] & 0xC0) != 0x80 ||
+                    (bytes[i + 3] & 0xC0) != 0x80) return false;
+                i += 4;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 按不超过4KB的块计时，块在换行处断开，多字节字符不会被切开；chunk_fn返回值计入BenchKeep
+    template<typename Fn>
+    uint64_t TimeChunks(std::string_view data, int repeat, Fn&& chunk_fn) {
+        uint64_t keep = 0;
+        const uint64_t start = PerfNowNs();
+        for (int r = 0; r < repeat; ++r) {
+            for (size_t pos = 0; pos < data.size();) {
+                std::string_view chunk = data.substr(pos, kChunkSize);
+                const size_t newline = chunk.rfind('\n');
+                if (pos + chunk.size() < data.size() && newline != std::string_view::npos) {
+                    chunk = chunk.substr(0, newline + 1);
+                }
+                keep += chunk_fn(chunk);
+                pos += chunk.size();
+            }
+        }
+        const uint64_t elapsed = PerfNowNs() - start;
+        BenchKeep(keep);
+        return elapsed / static_cast<uint64_t>(repeat);
+    }
+}
+
+// 加速比以改动前的原实现为基准；严格标量列是SIMD不可用时的回退路径，校验规则与SIMD相同
+void RunUtf8Bench(const BenchOptions& options) {
+    const size_t bytes = BenchScale(16 * 1024 * 1024, options);
+    const int repeat = options.quick ? 1 : 5;
+
+    std::printf("%-8s %14s %14s %14s %12s\n", "语料", "SIMD MB/s", "严格标量 MB/s", "原实现 MB/s", "对原实现");
+    for (CorpusKind kind : {CorpusKind::Ascii, CorpusKind::Cjk, CorpusKind::Mixed}) {
+        const std::string corpus = MakeUtf8Corpus(kind, bytes);
+        // 整段校验，不按块切分(块边界可能截断多字节字符)
+        uint64_t keep = 0;
+        uint64_t start = PerfNowNs();
+        for (int r = 0; r < repeat; ++r) keep += IsValidUTF8(corpus);
+        const uint64_t simd_ns = (PerfNowNs() - start) / static_cast<uint64_t>(repeat);
+        start = PerfNowNs();
+        for (int r = 0; r < repeat; ++r) keep += IsValidUTF8Scalar(corpus);
+        const uint64_t scalar_ns = (PerfNowNs() - start) / static_cast<uint64_t>(repeat);
+        start = PerfNowNs();
+        for (int r = 0; r < repeat; ++r) keep += OriginalIsValidUTF8(corpus);
+        const uint64_t original_ns = (PerfNowNs() - start) / static_cast<uint64_t>(repeat);
+        BenchKeep(keep);
+
+        std::printf("%-8s %14.0f %14.0f %14.0f %11.1fx\n", CorpusName(kind), MegabytesPerSecond(corpus.size(), simd_ns),
+                    MegabytesPerSecond(corpus.size(), scalar_ns), MegabytesPerSecond(corpus.size(), original_ns),
+                    static_cast<double>(original_ns) / static_cast<double>(simd_ns ? simd_ns : 1));
+    }
+    std::printf("(原实现：改动前CLIProcess::IsValidUTF8的逐字节循环，不检查过长编码和代理区)\n");
+}
+
+// 锁定后：同一检测器连续处理整段输出；未锁定：每块前Reset，相当于每块都做完整评估
+void RunDetectorBench(const BenchOptions& options) {
+    const size_t bytes = BenchScale(16 * 1024 * 1024, options);
+    const std::string utf8 = MakeUtf8Corpus(CorpusKind::Mixed, bytes);
+    const std::string japanese = MakeUtf8Corpus(CorpusKind::Japanese, bytes);
+
+    std::printf("%-12s %14s %14s %-12s\n", "实际编码", "锁定后 ms/MB", "未锁定 ms/MB", "检测结果");
+    auto run = [&](OutputEncoding actual, const std::string& data) {
+        const double megabytes = static_cast<double>(data.size()) / (1024.0 * 1024.0);
+        EncodingDetector detector;
+        const uint64_t locked_ns = TimeChunks(data, 1, [&](std::string_view chunk) {
+            return static_cast<uint64_t>(detector.Resolve(chunk));
+        });
+        const EncodingDetector::Result result = detector.Current();
+
+        EncodingDetector fresh;
+        const uint64_t fresh_ns = TimeChunks(data, 1, [&](std::string_view chunk) {
+            fresh.Reset();
+            return static_cast<uint64_t>(fresh.Resolve(chunk));
+        });
+
+        std::printf("%-12s %14.3f %14.3f %-12s%s\n", CLIProcess::GetEncodingName(actual).c_str(),
+                    static_cast<double>(locked_ns) / 1e6 / megabytes,
+                    static_cast<double>(fresh_ns) / 1e6 / megabytes,
+                    CLIProcess::GetEncodingName(result.encoding).c_str(),
+                    result.encoding == actual ? "" : "  (不符)");
+    };
+
+    run(OutputEncoding::UTF8, utf8);
+    std::string encoded;
+    for (OutputEncoding encoding : kMultiByteEncodings) {
+        if (!SystemFromUtf8(IsJapanese(encoding) ? japanese : utf8, encoding, encoded)) {
+            std::printf("%-12s 系统接口不支持该编码，跳过\n", CLIProcess::GetEncodingName(encoding).c_str());
+            continue;
+        }
+        run(encoding, encoded);
+    }
+}
+
+// 对照组为系统转换接口(Windows经UTF-16中转，其他平台为iconv)，同时核对两者输出一致
+void RunTranscoderBench(const BenchOptions& options) {
+    const size_t bytes = BenchScale(16 * 1024 * 1024, options);
+    const std::string mixed = MakeUtf8Corpus(CorpusKind::Mixed, bytes);
+    const std::string japanese = MakeUtf8Corpus(CorpusKind::Japanese, bytes);
+    const int repeat = options.quick ? 1 : 3;
+
+    std::printf("%-12s %14s %14s %8s %8s\n", "编码", "内置 MB/s", "系统接口 MB/s", "加速比", "输出一致");
+    std::string encoded;
+    std::string buffer;
+    std::string system_out;
+    for (OutputEncoding encoding : kMultiByteEncodings) {
+        const std::string name = CLIProcess::GetEncodingName(encoding);
+        if (!CanTranscodeToUtf8(encoding)) {
+            std::printf("%-12s 无内置转换表(由系统接口处理)，跳过\n", name.c_str());
+            continue;
+        }
+        const std::string& utf8 = IsJapanese(encoding) ? japanese : mixed;
+        if (!SystemFromUtf8(utf8, encoding, encoded)) {
+            std::printf("%-12s 系统接口不支持该编码，跳过\n", name.c_str());
+            continue;
+        }
+
+        const uint64_t table_ns = TimeChunks(encoded, repeat, [&](std::string_view chunk) {
+            return TranscodeToUtf8(chunk, encoding, buffer).size();
+        });
+        const uint64_t system_ns = TimeChunks(encoded, repeat, [&](std::string_view chunk) {
+            SystemToUtf8(chunk, encoding, system_out);
+            return system_out.size();
+        });
+
+        const std::string_view table_whole = TranscodeToUtf8(encoded, encoding, buffer);
+        const bool same = SystemToUtf8(encoded, encoding, system_out) && table_whole == system_out &&
+                          table_whole == utf8;
+
+        std::printf("%-12s %14.0f %14.0f %7.1fx %8s\n", name.c_str(), MegabytesPerSecond(encoded.size(), table_ns),
+                    MegabytesPerSecond(encoded.size(), system_ns),
+                    static_cast<double>(system_ns) / static_cast<double>(table_ns ? table_ns : 1),
+                    same ? "是" : "否");
+    }
+}
@@ -0,0 +1,109 @@
+#include "Bench.h"
+#include "LogFileSink.h"
+#include "PerfCounters.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct SinkRun {
+        uint64_t append_ns;     // 调用方Append耗时
+        uint64_t total_ns;      // 含Stop()写完缓冲区(及压缩)的总耗时
+        LogFileSink::Stats stats;
+    };
+
+    // rate_mb为0时不限速；限速时每10ms追加一批
+    SinkRun RunSink(const std::vector<std::string>& lines, size_t total_bytes, const LogFileSinkConfig& config,
+                    double rate_mb) {
+        std::error_code ec;
+        std::filesystem::remove_all(config.directory, ec);
+
+        LogFileSink sink;
+        sink.Start(config);
+
+        const uint64_t start = PerfNowNs();
+        uint64_t append_ns = 0;
+        size_t appended = 0;
+        size_t index = 0;
+        const size_t batch_bytes = rate_mb > 0 ? static_cast<size_t>(rate_mb * 1024 * 1024 / 100) : total_bytes;
+        while (appended < total_bytes) {
+            const uint64_t batch_start = PerfNowNs();
+            size_t batch = 0;
+            while (batch < batch_bytes && appended < total_bytes) {
+                const std::string& line = lines[index++ % lines.size()];
+                sink.Append(line);
+                batch += line.size() + 1;
+                appended += line.size() + 1;
+            }
+            const uint64_t batch_end = PerfNowNs();
+            append_ns += batch_end - batch_start;
+            if (rate_mb > 0) {
+                const uint64_t due = start + static_cast<uint64_t>(static_cast<double>(appended) /
+                                                                   (rate_mb * 1024 * 1024) * 1e9);
+                if (due > batch_end) std::this_thread::sleep_for(std::chrono::nanoseconds(due - batch_end));
+            }
+        }
+        sink.Stop();
+        const uint64_t total_ns = PerfNowNs() - start;
+
+        SinkRun run{append_ns, total_ns, sink.GetStats()};
+        std::filesystem::remove_all(config.directory, ec);
+        return run;
+    }
+}
+
+// 需求要求写入端能跟上100MB/s的子进程输出：限速一行的丢弃字节数应为0
+void RunFileSinkBench(const BenchOptions& options) {
+    std::vector<std::string> lines;
+    {
+        const std::string corpus = MakeUtf8Corpus(CorpusKind::Mixed, 4 * 1024 * 1024);
+        for (size_t pos = 0; pos < corpus.size();) {
+            const size_t end = corpus.find('\n', pos);
+            lines.emplace_back(corpus, pos, end - pos);
+            pos = end + 1;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+    if (ec) dir = ".";
+    dir /= "climanager_bench_sink";
+
+    LogFileSinkConfig plain;
+    plain.directory = dir;
+    plain.max_file_bytes = 64ull * 1024 * 1024;
+    plain.max_file_age = std::chrono::seconds(0);
+    plain.max_files = 0;
+
+    LogFileSinkConfig compressed = plain;
+    compressed.max_file_bytes = 16ull * 1024 * 1024;
+    compressed.compress_closed = true;
+
+    const size_t total = BenchScale(512ull * 1024 * 1024, options);
+    const size_t paced_total = BenchScale(400ull * 1024 * 1024, options);
+
+    struct Case {
+        const char* name;
+        const LogFileSinkConfig* config;
+        size_t bytes;
+        double rate_mb;
+    };
+    const Case cases[] = {
+        {"不限速", &plain, total, 0},
+        {"不限速+轮转压缩", &compressed, total, 0},
+        {"限速100MB/s", &plain, paced_total, 100},
+    };
+
+    std::printf("%-18s %10s %14s %14s %12s\n", "场景", "写入MB", "Append MB/s", "落盘 MB/s", "丢弃MB");
+    for (const Case& c : cases) {
+        const SinkRun run = RunSink(lines, c.bytes, *c.config, c.rate_mb);
+        std::printf("%-18s %10zu %14.0f %14.0f %12.1f\n", c.name, c.bytes >> 20,
+                    MegabytesPerSecond(c.bytes, run.append_ns),
+                    MegabytesPerSecond(static_cast<size_t>(run.stats.written_bytes), run.total_ns),
+                    static_cast<double>(run.stats.dropped_bytes) / (1024.0 * 1024.0));
+    }
+}
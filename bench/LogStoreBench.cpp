@@ -0,0 +1,124 @@
+#include "Bench.h"
+#include "LineFramer.h"
+#include "LogStore.h"
+#include "PerfCounters.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string MakeLine(uint64_t index) {
+        std::string line = "2024-05-01 12:00:00 [INFO] worker-3 processed request #";
+        line.append(std::to_string(index));
+        line.append(" in 12ms");
+        return line;
+    }
+}
+
+// 先写满N行，再在持续淘汰的稳态下计时：环形存储每行成本应与N无关
+void RunLogStoreBench(const BenchOptions& options) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const size_t measured = BenchScale(1000000, options);
+
+    std::printf("%12s %12s %12s\n", "保留行数", "ns/行", "已淘汰行");
+    for (size_t retained : sizes) {
+        if (options.quick && retained > 100000) break;
+
+        LogStore store(SIZE_MAX, retained);
+        std::vector<std::string> lines;
+        lines.reserve(4096);
+        for (uint64_t i = 0; i < 4096; ++i) lines.push_back(MakeLine(i));
+
+        for (size_t i = 0; i < retained; ++i) store.Push(lines[i & 4095]);
+
+        const uint64_t start = PerfNowNs();
+        for (size_t i = 0; i < measured; ++i) store.Push(lines[i & 4095]);
+        const uint64_t elapsed = PerfNowNs() - start;
+
+        BenchKeep(store.Size());
+        std::printf("%12zu %12.1f %12llu\n", retained,
+                    static_cast<double>(elapsed) / static_cast<double>(measured),
+                    static_cast<unsigned long long>(retained + measured - store.Size()));
+    }
+}
+
+// 按管道读取的4KB块喂入分行器再入库(含ANSI解析与级别识别)，对照每行一个std::string的旧存储方式
+void RunIngestBench(const BenchOptions& options) {
+    const std::string plain = MakeUtf8Corpus(CorpusKind::Mixed, BenchScale(64 * 1024 * 1024, options));
+    // 每8行一行带颜色，覆盖ANSI解析路径
+    std::string corpus;
+    corpus.reserve(plain.size() + plain.size() / 64);
+    size_t line_index = 0;
+    for (size_t pos = 0; pos < plain.size(); ++line_index) {
+        const size_t end = plain.find('\n', pos);
+        const std::string_view text(plain.data() + pos, end - pos);
+        if (line_index % 8 == 0) {
+            corpus.append("\x1b[32m").append(text).append("\x1b[0m\n");
+        } else {
+            corpus.append(text).append("\n");
+        }
+        pos = end + 1;
+    }
+    constexpr size_t kReadSize = 4096;
+
+    // 额外字节按堆上实际仍在使用的字节计算，块内未用的容量和预分配的元数据都计入
+    const uint64_t live_before = BenchLiveBytes();
+    LogStore store(SIZE_MAX, 0);
+    LineFramer framer;
+    size_t lines = 0;
+    size_t text_bytes = 0;
+    uint64_t allocations = 0;   // 只统计存储本身的分配，分行器交出的临时串不计
+    auto push = [&](std::string&& line) {
+        const uint64_t before = BenchAllocations();
+        store.Push(line);
+        allocations += BenchAllocations() - before;
+        ++lines;
+    };
+
+    const uint64_t start = PerfNowNs();
+    for (size_t pos = 0; pos < corpus.size(); pos += kReadSize) {
+        framer.Feed(std::string_view(corpus).substr(pos, kReadSize), push);
+    }
+    framer.Flush(push);
+    const uint64_t elapsed = PerfNowNs() - start;
+    const uint64_t store_bytes = BenchLiveBytes() - live_before;
+
+    const auto snapshot = store.Snapshot();
+    for (uint64_t id = snapshot->BeginId(); id < snapshot->EndId(); ++id) {
+        text_bytes += snapshot->ById(id).size();
+    }
+
+    // 对照：每行一个std::string，分行器交出的串直接存入，其分配即每行的分配
+    const uint64_t baseline_live_before = BenchLiveBytes();
+    std::vector<std::string> baseline;
+    LineFramer baseline_framer;
+    auto push_baseline = [&](std::string&& line) {
+        baseline.push_back(std::move(line));
+    };
+    const uint64_t baseline_allocations_before = BenchAllocations();
+    const uint64_t baseline_start = PerfNowNs();
+    for (size_t pos = 0; pos < corpus.size(); pos += kReadSize) {
+        baseline_framer.Feed(std::string_view(corpus).substr(pos, kReadSize), push_baseline);
+    }
+    baseline_framer.Flush(push_baseline);
+    const uint64_t baseline_elapsed = PerfNowNs() - baseline_start;
+    const uint64_t baseline_allocations = BenchAllocations() - baseline_allocations_before;
+    const uint64_t baseline_bytes = BenchLiveBytes() - baseline_live_before;
+
+    const double avg_text = static_cast<double>(text_bytes) / static_cast<double>(lines);
+    std::printf("%d MB 输入, %zu 行, 平均文本 %.1f 字节/行\n",
+                static_cast<int>(corpus.size() >> 20), lines, avg_text);
+    std::printf("%-22s %10s %12s %14s %14s\n", "存储", "MB/s", "M行/s", "额外字节/行", "分配次数/行");
+    std::printf("%-22s %10.0f %12.2f %14.1f %14.3f\n", "LogStore", MegabytesPerSecond(corpus.size(), elapsed),
+                static_cast<double>(lines) * 1e3 / static_cast<double>(elapsed),
+                static_cast<double>(store_bytes) / static_cast<double>(lines) - avg_text,
+                static_cast<double>(allocations) / static_cast<double>(lines));
+    std::printf("%-22s %10.0f %12.2f %14.1f %14.3f\n", "vector<string>(仅存储)",
+                MegabytesPerSecond(corpus.size(), baseline_elapsed),
+                static_cast<double>(baseline.size()) * 1e3 / static_cast<double>(baseline_elapsed),
+                static_cast<double>(baseline_bytes) / static_cast<double>(baseline.size()) - avg_text,
+                static_cast<double>(baseline_allocations) / static_cast<double>(baseline.size()));
+    std::printf("(额外字节按堆上仍在使用的字节计：LogStore含颜色段表、块内未用容量和预分配的元数据，"
+                "vector<string>含其扩容余量；对照不做ANSI解析与级别识别)\n");
+}
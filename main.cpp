@@ -1,6 +1,7 @@
+#include "Headless.h"
 #include "Manager.h"
 
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
+static int RunGui() {
     Manager manager;
     if (!manager.Initialize()) {
         return 1;
@@ -8,4 +9,21 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
     manager.Run();
     manager.Shutdown();
     return 0;
-}
\ No newline at end of file
+}
+
+#ifdef _WIN32
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int) {
+    // --headless时不创建窗口、不加载任何界面组件
+    if (IsHeadlessRequested(__argc, __argv)) {
+        return RunHeadless();
+    }
+    return RunGui();
+}
+#else
+int main(int argc, char** argv) {
+    if (IsHeadlessRequested(argc, argv)) {
+        return RunHeadless();
+    }
+    return RunGui();
+}
+#endif
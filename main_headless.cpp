@@ -0,0 +1,7 @@
+#include "Headless.h"
+
+// climanager_headless：只链接climanager_core的无界面托管程序，启动时不加载任何界面相关的库。
+// 与CLI_Manager --headless行为相同，读取当前目录下的climanager_settings.ini
+int main() {
+    return RunHeadless();
+}
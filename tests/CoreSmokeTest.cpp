@@ -0,0 +1,305 @@
+#include "AnsiParser.h"
+#include "AppState.h"
+#include "CLIProcess.h"
+#include "LineFramer.h"
+#include "LogFileSink.h"
+#include "LogFilterView.h"
+#include "LogLevel.h"
+#include "LogStore.h"
+#include "Transcoder.h"
+#include "Utf8.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// climanager_core冒烟测试：每个模块走一遍最基本的路径，确认库能链接并在当前平台上正常工作
+namespace {
+    int g_failures = 0;
+
+#define CHECK(expr)                                                             \
+    do {                                                                        \
+        if (!(expr)) {                                                          \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #expr); \
+            ++g_failures;                                                       \
+        }                                                                       \
+    } while (0)
+
+    void TestLogStore() {
+        LogStore store(SIZE_MAX, 2);
+        store.Push("first");
+        store.Push("\x1b[31m[ERROR] second\x1b[0m");
+        store.Push("third");
+
+        const auto snapshot = store.Snapshot();
+        CHECK(snapshot->Size() == 2);
+        const LogLineView second = snapshot->ViewById(snapshot->BeginId());
+        CHECK(second.text == "[ERROR] second");
+        CHECK(second.RunCount() >= 1);
+        CHECK(second.Level() == LogLevel::Error);
+        CHECK((*snapshot)[1] == "third");
+
+        // 增量搜索：从上次的EndId()继续只查新到达的行，有无索引结果一致
+        for (const bool indexed : {false, true}) {
+            LogStore searched(SIZE_MAX, 0);
+            searched.SetSearchIndexEnabled(indexed);
+            for (int i = 0; i < 200; ++i) searched.Push(i % 50 == 0 ? "needle here" : "hay");
+            CHECK(searched.Search("needle", 100).size() == 4);
+            const uint64_t searched_end = searched.EndId();
+            searched.Push("another NEEDLE");
+            const auto added = searched.Search("needle", 100, searched_end);
+            CHECK(added.size() == 1 && added[0] == searched_end);
+            CHECK(searched.Search("ne", 100, searched_end).size() == 1);
+        }
+
+        // 字节预算按块实际分配的内存计算：短行填不满块，计入的仍是整块容量
+        constexpr size_t kBudget = 1 << 20;
+        constexpr size_t kChunkBytes = LogChunk::kBytes + LogChunk::kLines * sizeof(LogLineMeta);
+        LogStore budgeted(kBudget, 0);
+        for (int i = 0; i < 100000; ++i) budgeted.Push("short line");
+        CHECK(budgeted.RetainedBytes() <= kBudget);
+        CHECK(budgeted.RetainedBytes() % kChunkBytes == 0);
+        // 1 MB只容得下3块：两个满块加正在写入的块
+        CHECK(budgeted.RetainedBytes() == 3 * kChunkBytes);
+        CHECK(budgeted.Size() == 2 * LogChunk::kLines + 100000 % LogChunk::kLines);
+    }
+
+    // 后台过滤完成时调用唤醒回调，之后一次Update即可取到结果
+    void TestLogFilterView() {
+        LogStore store(SIZE_MAX, 0);
+        for (int i = 0; i < 10000; ++i) store.Push(i % 100 == 0 ? "Match" : "other");
+
+        std::atomic<bool> woken{false};
+        LogFilterView view;
+        view.SetWakeCallback([&woken]() { woken.store(true); });
+        view.SetPattern("match", store.Snapshot());
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!woken.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(woken.load());
+        view.Update(*store.Snapshot());
+        CHECK(!view.Scanning());
+        CHECK(view.Size() == 100);
+    }
+
+    uint32_t FirstRunColor(std::string_view line) {
+        uint32_t color = 1;
+        bool first = true;
+        ParseAnsiRuns(line, [&](const AnsiRun& run) {
+            if (first) color = run.color;
+            first = false;
+        });
+        return color;
+    }
+
+    // 扩展颜色的分号格式和冒号(ITU T.416)格式
+    void TestAnsiColors() {
+        CHECK(FirstRunColor("\x1b[38;2;10;20;30mx") == AnsiPackColor(10, 20, 30));
+        CHECK(FirstRunColor("\x1b[38:2::10:20:30mx") == AnsiPackColor(10, 20, 30));
+        CHECK(FirstRunColor("\x1b[38:2:0:10:20:30mx") == AnsiPackColor(10, 20, 30));
+        CHECK(FirstRunColor("\x1b[38:2:10:20:30mx") == AnsiPackColor(10, 20, 30));
+        CHECK(FirstRunColor("\x1b[38;5;196mx") == kAnsiPalette[196]);
+        CHECK(FirstRunColor("\x1b[38:5:196mx") == kAnsiPalette[196]);
+        // 子参数整组跳过，不会被当成后续参数
+        CHECK(FirstRunColor("\x1b[48:2::1:2:3;31mx") == kAnsiPalette[1]);
+        CHECK(FirstRunColor("\x1b[4:3;32mx") == kAnsiPalette[2]);
+        CHECK(FirstRunColor("\x1b[38:5:33;1mx") == kAnsiPalette[33]);
+    }
+
+    void TestLineFramer() {
+        LineFramer framer;
+        std::vector<std::string> lines;
+        auto push = [&](std::string&& line) { lines.push_back(std::move(line)); };
+        framer.Feed("a\r\nb", push);
+        framer.Feed("c\nd", push);
+        framer.Flush(push);
+        CHECK((lines == std::vector<std::string>{"a", "bc", "d"}));
+    }
+
+    void TestEncoding() {
+        CHECK(IsValidUTF8("plain ascii \xE4\xB8\xAD\xE6\x96\x87"));
+        CHECK(!IsValidUTF8("\xC0\xAF"));            // 超长编码
+        CHECK(!IsValidUTF8("\xED\xA0\x80"));        // 代理区
+        CHECK(ClassifyLogLevel("2024 [WARN] disk") == LogLevel::Warn);
+
+#ifdef _WIN32
+        const OutputEncoding gbk = OutputEncoding::GBK;
+#else
+        const OutputEncoding gbk = OutputEncoding::GB18030;
+#endif
+        std::string buffer;
+        CHECK(TranscodeToUtf8("\xD6\xD0\xCE\xC4 ok", gbk, buffer) == "\xE4\xB8\xAD\xE6\x96\x87 ok");
+    }
+
+    // 把各类无效(以及有效)序列放到32字节块边界前后的每个位置，SIMD实现与标量实现的结论必须一致。
+    // 总长96字节时走整块路径和跨块进位检查；序列位于末尾时走补零的尾块路径
+    void TestUtf8BlockBoundaries() {
+        struct Sample {
+            const char* bytes;
+            bool valid;
+        };
+        const Sample samples[] = {
+            {"\xE4\xB8\xAD", true},
+            {"\xF0\x9F\x98\x80", true},
+            {"\xF4\x8F\xBF\xBF", true},
+            {"\xC3", false},                   // 截断
+            {"\xE4\xB8", false},
+            {"\xF0\x9F\x98", false},
+            {"\xB8", false},                   // 孤立的后续字节
+            {"\xC0\xAF", false},              // 超长编码
+            {"\xE0\x80\xAF", false},
+            {"\xF0\x80\x80\xAF", false},
+            {"\xED\xA0\x80", false},         // 代理区
+            {"\xED\xBF\xBF", false},
+            {"\xF4\x90\x80\x80", false},    // 大于U+10FFFF
+            {"\xF5\x80\x80\x80", false},
+            {"\xFF", false},
+        };
+        constexpr size_t kTotal = 96;
+        for (const Sample& sample : samples) {
+            const std::string seq = sample.bytes;
+            for (size_t offset = 0; offset + seq.size() <= kTotal; ++offset) {
+                // 前缀以"中"开头使所在块不是纯ASCII，后缀有时以"é"开头
+                std::string prefix = offset >= 3 ? "\xE4\xB8\xAD" + std::string(offset - 3, 'a')
+                                                 : std::string(offset, 'a');
+                const size_t rest = kTotal - offset - seq.size();
+                std::string suffix = rest >= 2 && offset % 2 == 0 ? "\xC3\xA9" + std::string(rest - 2, 'b')
+                                                                  : std::string(rest, 'b');
+                for (const std::string& text : {prefix + seq + suffix, prefix + seq}) {
+                    const bool simd = IsValidUTF8(text);
+                    const bool scalar = IsValidUTF8Scalar(text);
+                    if (simd != scalar || simd != sample.valid) {
+                        std::fprintf(stderr, "UTF-8校验不一致: 偏移%zu 长度%zu simd=%d scalar=%d\n",
+                                     offset, text.size(), simd, scalar);
+                        ++g_failures;
+                    }
+                }
+            }
+        }
+    }
+
+    // 在临时目录中写入设置文件并加载到state
+    void LoadSettingsFrom(const std::string& ini, AppState& state) {
+        namespace fs = std::filesystem;
+        const fs::path previous = fs::current_path();
+        const fs::path dir = fs::temp_directory_path() / "climanager_settings_smoke";
+        fs::create_directories(dir);
+        fs::current_path(dir);
+        {
+            std::ofstream file("climanager_settings.ini", std::ios::trunc);
+            file << ini;
+        }
+        state.LoadSettings();
+        fs::current_path(previous);
+        fs::remove_all(dir);
+    }
+
+    void TestSettingsMigration() {
+        // 旧版本的设置文件总带有100~10000之间的MaxLogLines，加载后应改按字节预算保留
+        AppState legacy;
+        const uint64_t default_bytes = legacy.max_log_bytes;
+        LoadSettingsFrom("[Settings]\nMaxLogLines=1000\n", legacy);
+        CHECK(legacy.max_log_lines == 0);
+        CHECK(legacy.max_log_bytes == default_bytes);
+
+        AppState capped;
+        LoadSettingsFrom("[Settings]\nMaxLogLineCap=5000\nMaxLogBytes=8388608\n", capped);
+        CHECK(capped.max_log_lines == 5000);
+        CHECK(capped.max_log_bytes == 8388608);
+    }
+
+    size_t CountLogFiles(const std::filesystem::path& dir) {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            if (entry.path().extension() == ".log") ++count;
+        }
+        return count;
+    }
+
+    // 配置不变时重复Start不轮转，配置变化才换新文件
+    void TestLogFileSink() {
+        const auto dir = std::filesystem::temp_directory_path() / "climanager_core_smoke_logs";
+        std::filesystem::remove_all(dir);
+
+        LogFileSinkConfig config;
+        config.directory = dir;
+        LogFileSink sink;
+        sink.Start(config);
+        sink.Append("first");
+        sink.Start(config);
+        sink.Append("second");
+        sink.Stop();
+        CHECK(CountLogFiles(dir) == 1);
+
+        sink.Start(config);
+        sink.Append("third");
+        config.max_file_bytes /= 2;
+        sink.Start(config);
+        sink.Append("fourth");
+        sink.Stop();
+        CHECK(CountLogFiles(dir) == 3);
+
+        // 压缩后的文件不留索引
+        std::filesystem::remove_all(dir);
+        config.compress_closed = true;
+        sink.Start(config);
+        sink.Append("compressed");
+        sink.Stop();
+        size_t packed = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            CHECK(entry.path().extension() == ".lzb");
+            ++packed;
+        }
+        CHECK(packed == 1);
+
+        std::filesystem::remove_all(dir);
+    }
+
+    void TestProcess() {
+        CLIProcess process;
+        process.SetAutoWorkingDir(false);
+#ifdef _WIN32
+        process.Start("cmd /c echo core-smoke");
+#else
+        process.Start("echo core-smoke");
+#endif
+        bool seen = false;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!seen && std::chrono::steady_clock::now() < deadline) {
+            process.DrainIngestQueue();
+            const auto logs = process.GetLogSnapshot();
+            for (uint64_t id = logs->BeginId(); id < logs->EndId(); ++id) {
+                if (logs->ById(id) == "core-smoke") seen = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        process.Stop();
+        CHECK(seen);
+        CHECK(!process.IsRunning());
+    }
+}
+
+int main() {
+    TestLogStore();
+    TestLogFilterView();
+    TestAnsiColors();
+    TestLineFramer();
+    TestEncoding();
+    TestUtf8BlockBoundaries();
+    TestSettingsMigration();
+    TestLogFileSink();
+    TestProcess();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", g_failures);
+        return 1;
+    }
+    std::printf("climanager_core 冒烟测试通过\n");
+    return 0;
+}
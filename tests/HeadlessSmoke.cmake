@@ -0,0 +1,28 @@
+# 用法: cmake -DHEADLESS=<climanager_headless路径> -DWORK_DIR=<临时目录> -P HeadlessSmoke.cmake
+# 写入只配置了启动命令的设置文件，运行climanager_headless几秒后结束它，检查子进程的输出已写入日志文件
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+
+if(WIN32)
+    set(command "cmd /c echo headless-smoke")
+else()
+    set(command "echo headless-smoke")
+endif()
+file(WRITE "${WORK_DIR}/climanager_settings.ini"
+        "[Settings]\nCommandInput=${command}\nAutoWorkDirectory=0\nLogFileDirectory=logs\n")
+
+# 看护循环不会自行退出，超时后由execute_process结束；日志文件每200ms落盘一次
+execute_process(COMMAND "${HEADLESS}"
+        WORKING_DIRECTORY "${WORK_DIR}"
+        TIMEOUT 3
+        ERROR_VARIABLE status)
+
+file(GLOB log_files "${WORK_DIR}/logs/*.log")
+if(NOT log_files)
+    message(FATAL_ERROR "climanager_headless没有写出日志文件\n${status}")
+endif()
+file(READ ${log_files} content)
+if(NOT content MATCHES "headless-smoke")
+    message(FATAL_ERROR "日志文件中没有子进程的输出\n${status}")
+endif()
+file(REMOVE_RECURSE "${WORK_DIR}")
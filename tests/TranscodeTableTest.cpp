@@ -0,0 +1,156 @@
+#include "Transcoder.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <iconv.h>
+#endif
+
+// 内置转换表与系统转换接口逐码对照：遍历每种编码的全部单字节和双字节码(GB18030另含四字节区的BMP部分)，
+// 系统接口能解码时两者输出必须完全相同；系统接口拒绝时内置表只能输出U+FFFD或私用区码点(用户自定义区)
+namespace {
+    using CodePoints = std::vector<uint32_t>;
+
+    struct Target {
+        OutputEncoding encoding;
+        const char* name;
+#ifdef _WIN32
+        UINT code_page;
+#else
+        const char* iconv_name;
+#endif
+        unsigned lead_begin;
+        unsigned lead_end;      // 含
+    };
+
+#ifdef _WIN32
+    const Target kTargets[] = {
+        {OutputEncoding::GBK, "GBK", 936, 0x81, 0xFE},
+        {OutputEncoding::BIG5, "Big5", 950, 0x81, 0xFE},
+        {OutputEncoding::SHIFT_JIS, "Shift-JIS", 932, 0x81, 0xFC},
+    };
+
+    bool SystemDecode(const Target& target, std::string_view input, CodePoints& out) {
+        wchar_t wide[8];
+        const int length = MultiByteToWideChar(target.code_page, MB_ERR_INVALID_CHARS, input.data(),
+                                               static_cast<int>(input.size()), wide, 8);
+        if (length <= 0) return false;
+        out.clear();
+        for (int i = 0; i < length; ++i) {
+            uint32_t cp = static_cast<uint16_t>(wide[i]);
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < length) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (static_cast<uint16_t>(wide[++i]) - 0xDC00);
+            }
+            out.push_back(cp);
+        }
+        return true;
+    }
+#else
+    const Target kTargets[] = {
+        {OutputEncoding::GB18030, "GB18030", "GB18030", 0x81, 0xFE},
+        {OutputEncoding::BIG5, "Big5", "BIG5", 0x81, 0xFE},
+        {OutputEncoding::ISO_8859_1, "ISO-8859-1", "ISO-8859-1", 0, 0},
+    };
+
+    bool SystemDecode(const Target& target, std::string_view input, CodePoints& out) {
+        iconv_t cd = iconv_open("UTF-32LE", target.iconv_name);
+        if (cd == reinterpret_cast<iconv_t>(-1)) return false;
+        char* in = const_cast<char*>(input.data());
+        size_t in_left = input.size();
+        uint32_t buffer[8];
+        char* dst = reinterpret_cast<char*>(buffer);
+        size_t out_left = sizeof(buffer);
+        const size_t result = iconv(cd, &in, &in_left, &dst, &out_left);
+        iconv_close(cd);
+        if (result == static_cast<size_t>(-1) || in_left != 0) return false;
+        out.assign(buffer, buffer + (sizeof(buffer) - out_left) / sizeof(uint32_t));
+        return true;
+    }
+#endif
+
+    CodePoints DecodeUtf8(std::string_view utf8) {
+        CodePoints out;
+        for (size_t i = 0; i < utf8.size();) {
+            const auto lead = static_cast<unsigned char>(utf8[i]);
+            const size_t length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+            uint32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+            for (size_t k = 1; k < length && i + k < utf8.size(); ++k) {
+                cp = (cp << 6) | (static_cast<unsigned char>(utf8[i + k]) & 0x3F);
+            }
+            out.push_back(cp);
+            i += length;
+        }
+        return out;
+    }
+
+    bool IsPrivateUse(uint32_t cp) {
+        return cp >= 0xE000 && cp <= 0xF8FF;
+    }
+
+    int CheckTarget(const Target& target) {
+        std::vector<std::string> inputs;
+        for (unsigned b = 0x80; b <= 0xFF; ++b) {
+            inputs.emplace_back(1, static_cast<char>(b));
+        }
+        for (unsigned lead = target.lead_begin; target.lead_end != 0 && lead <= target.lead_end; ++lead) {
+            for (unsigned trail = 0x40; trail <= 0xFE; ++trail) {
+                inputs.push_back({static_cast<char>(lead), static_cast<char>(trail)});
+            }
+        }
+        if (target.encoding == OutputEncoding::GB18030) {
+            // 四字节区的BMP部分 81308130-8431A439
+            for (unsigned index = 0; index < 39420; ++index) {
+                inputs.push_back({static_cast<char>(0x81 + index / 12600), static_cast<char>(0x30 + index % 12600 / 1260),
+                                  static_cast<char>(0x81 + index % 1260 / 10), static_cast<char>(0x30 + index % 10)});
+            }
+        }
+
+        int mismatches = 0;
+        std::string buffer;
+        CodePoints expected;
+        for (const std::string& input : inputs) {
+            const CodePoints actual = DecodeUtf8(TranscodeToUtf8(input, target.encoding, buffer));
+            bool ok;
+            if (SystemDecode(target, input, expected)) {
+                ok = actual == expected;
+            } else {
+                ok = !actual.empty() && (actual[0] == 0xFFFD || (actual.size() == 1 && IsPrivateUse(actual[0])));
+                expected.clear();
+            }
+            if (ok) continue;
+
+            if (++mismatches <= 20) {
+                unsigned code = 0;
+                for (const char c : input) code = (code << 8) | static_cast<unsigned char>(c);
+                std::fprintf(stderr, "%s %0*X: 内置表 U+%04X, ", target.name,
+                             static_cast<int>(input.size() * 2), code, actual.empty() ? 0u : actual[0]);
+                if (expected.empty()) {
+                    std::fprintf(stderr, "系统接口拒绝\n");
+                } else {
+                    std::fprintf(stderr, "系统接口 U+%04X\n", expected[0]);
+                }
+            }
+        }
+        if (mismatches > 0) {
+            std::fprintf(stderr, "%s: %d 个码与系统转换接口不一致\n", target.name, mismatches);
+        }
+        return mismatches;
+    }
+}
+
+int main() {
+    int failures = 0;
+    for (const Target& target : kTargets) {
+        if (!CanTranscodeToUtf8(target.encoding)) continue;
+        failures += CheckTarget(target);
+    }
+    if (failures > 0) return 1;
+    std::printf("内置转换表与系统转换接口一致\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+# 生成 app/src/TranscodeTables.cpp：GBK(CP936)、GB18030、Big5(CP950)、Shift-JIS(CP932) 到Unicode的查找表
+# 用法：python3 tools/gen_transcode_tables.py > app/src/TranscodeTables.cpp
+#
+# 映射以Python标准库编解码器为底，再按各平台实际使用的系统转换接口修正：
+# - GBK：Windows上替换的是MultiByteToWideChar(936)。Python的gbk与Microsoft发布的CP936.TXT(以及glibc的CP936)
+#   逐码一致，但CP936.TXT不含用户自定义区和GBK私用区，而Windows把它们按顺序映射到U+E000-U+E864；
+#   GB18030后来给其中一部分分配了正式码点，所以GBK不能直接套用GB18030的表
+# - GB18030：Linux上替换的是glibc iconv，它实现GB18030-2022(部分私用区码点改为正式码点)
+# - Big5：Windows为CP950，Linux上glibc的BIG5与CP950在双字节区一致。两者都把用户自定义区C6A1-C8FE
+#   映射到私用区，Python的cp950在这里给出的是倚天扩展的假名和符号，以系统为准
+# tests/TranscodeTableTest.cpp 在每个平台上把整张双字节表与系统转换接口逐码对照
+
+TRAIL_BEGIN, TRAIL_END = 0x40, 0xFF     # 第二字节范围 [0x40, 0xFE]
+TRAILS = TRAIL_END - TRAIL_BEGIN
+
+# GB18030-2022从私用区移到正式码点的双字节码(glibc同时把其中6个映射到CJK扩展B)
+GB18030_2022_TWO_BYTE = {
+    0xA6D9: 0xFE10, 0xA6DA: 0xFE12, 0xA6DB: 0xFE11, 0xA6DC: 0xFE13, 0xA6DD: 0xFE14,
+    0xA6DE: 0xFE15, 0xA6DF: 0xFE16, 0xA6EC: 0xFE17, 0xA6ED: 0xFE18, 0xA6F3: 0xFE19,
+    0xA8BC: 0x1E3F,
+    0xFE51: 0x20087, 0xFE52: 0x20089, 0xFE53: 0x200CC, 0xFE59: 0x9FB4, 0xFE61: 0x9FB5,
+    0xFE66: 0x9FB6, 0xFE67: 0x9FB7, 0xFE6C: 0x215D7, 0xFE6D: 0x9FB8, 0xFE76: 0x2298F,
+    0xFE7E: 0x9FB9, 0xFE90: 0x9FBA, 0xFE91: 0x241FE, 0xFEA0: 0x9FBB,
+}
+# 上面的码点原先由四字节码表示：U+1E3F的四字节码与A8BC互换，其余在glibc中不再可解码
+GB18030_2022_FOUR_BYTE_SWAPS = {0x1E3F: 0xE7C7}
+
+# Windows CP950用户自定义区，依次映射到U+E000起的私用区；每个首字节含0x40-0x7E和0xA1-0xFE共157个码位
+CP950_EUDC = [
+    (0xFA40, 0xFEFE),
+    (0x8E40, 0xA0FE),
+    (0x8140, 0x8DFE),
+    (0xC6A1, 0xC8FE),
+]
+
+
+def decode_two_byte(codec, lead, trail):
+    try:
+        text = bytes([lead, trail]).decode(codec)
+    except UnicodeDecodeError:
+        return 0
+    return ord(text) if len(text) == 1 else 0
+
+
+def two_byte_table(decode, leads):
+    return [decode(lead, trail) for lead in leads for trail in range(TRAIL_BEGIN, TRAIL_END)]
+
+
+def big5_trails():
+    return list(range(0x40, 0x7F)) + list(range(0xA1, 0xFF))
+
+
+def cp950_eudc():
+    mapping = {}
+    cp = 0xE000
+    for first, last in CP950_EUDC:
+        for lead in range(first >> 8, (last >> 8) + 1):
+            for trail in big5_trails():
+                code = (lead << 8) | trail
+                if first <= code <= last:
+                    mapping[code] = cp
+                    cp += 1
+    assert cp == 0xF849
+    return mapping
+
+
+def cp936_decoder():
+    # GBK未定义、GB18030(2000版)已定义的双字节码：用户自定义区直接沿用GB18030的私用区码点，
+    # 其余按码序依次占用U+E766-U+E864(GB18030-2000私用区映射即由此而来，之后部分改为正式码点)
+    mapping = {}
+    next_pua = 0xE766
+    for lead in range(0x81, 0xFF):
+        for trail in range(TRAIL_BEGIN, TRAIL_END):
+            if decode_two_byte('gbk', lead, trail):
+                continue
+            cp = decode_two_byte('gb18030', lead, trail)
+            if not cp:
+                continue
+            user_defined = (0xAA <= lead <= 0xAF or 0xF8 <= lead) and trail >= 0xA1 or \
+                           0xA1 <= lead <= 0xA7 and trail <= 0xA0
+            if user_defined:
+                assert 0xE000 <= cp < 0xE766
+            else:
+                assert cp == next_pua or not 0xE000 <= cp <= 0xF8FF
+                cp = next_pua
+                next_pua += 1
+            mapping[(lead << 8) | trail] = cp
+    assert next_pua == 0xE865
+
+    def decode(lead, trail):
+        return decode_two_byte('gbk', lead, trail) or mapping.get((lead << 8) | trail, 0)
+    return decode
+
+
+def gb18030_two_byte(lead, trail):
+    code = (lead << 8) | trail
+    if code in GB18030_2022_TWO_BYTE:
+        cp = GB18030_2022_TWO_BYTE[code]
+        return cp if cp <= 0xFFFF else 0
+    return decode_two_byte('gb18030', lead, trail)
+
+
+def big5_decoder():
+    eudc = cp950_eudc()
+
+    def decode(lead, trail):
+        code = (lead << 8) | trail
+        if code in eudc:
+            return eudc[code]
+        return decode_two_byte('cp950', lead, trail)
+    return decode
+
+
+def single_byte_table(codec):
+    table = []
+    for b in range(0x80, 0x100):
+        try:
+            text = bytes([b]).decode(codec)
+            table.append(ord(text) if len(text) == 1 else 0)
+        except UnicodeDecodeError:
+            table.append(0)
+    return table
+
+
+def gb18030_ranges():
+    # 四字节区(BMP部分)按线性序号分段，每段内码点连续
+    moved = {cp for cp in GB18030_2022_TWO_BYTE.values() if cp <= 0xFFFF}
+    ranges = []
+    for index in range(39420):
+        b1, rest = 0x81 + index // 12600, index % 12600
+        b2, rest = 0x30 + rest // 1260, rest % 1260
+        b3, b4 = 0x81 + rest // 10, 0x30 + rest % 10
+        try:
+            cp = ord(bytes([b1, b2, b3, b4]).decode('gb18030'))
+        except UnicodeDecodeError:
+            continue
+        if cp in GB18030_2022_FOUR_BYTE_SWAPS:
+            cp = GB18030_2022_FOUR_BYTE_SWAPS[cp]
+        elif cp in moved:
+            continue
+        if ranges and ranges[-1][0] + ranges[-1][1] == index and ranges[-1][2] + ranges[-1][1] == cp:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([index, 1, cp])
+    return ranges
+
+
+def emit_array(name, ctype, values, per_line=16):
+    print(f'const {ctype} {name}[{len(values)}] = {{')
+    for i in range(0, len(values), per_line):
+        print('    ' + ' '.join(f'0x{v:04X},' for v in values[i:i + per_line]))
+    print('};')
+    print()
+
+
+def main():
+    sjis_leads = list(range(0x81, 0xA0)) + list(range(0xE0, 0xFD))
+
+    print('// 由 tools/gen_transcode_tables.py 生成，请勿手工修改')
+    print('#include "TranscodeTables.h"')
+    print()
+    print('namespace transcode_tables {')
+    print()
+    emit_array('kGbkTwoByte', 'uint16_t', two_byte_table(cp936_decoder(), range(0x81, 0xFF)))
+    emit_array('kGb18030TwoByte', 'uint16_t', two_byte_table(gb18030_two_byte, range(0x81, 0xFF)))
+    emit_array('kBig5TwoByte', 'uint16_t', two_byte_table(big5_decoder(), range(0x81, 0xFF)))
+    emit_array('kShiftJisTwoByte', 'uint16_t',
+               two_byte_table(lambda lead, trail: decode_two_byte('cp932', lead, trail), sjis_leads))
+    emit_array('kShiftJisSingleByte', 'uint16_t', single_byte_table('cp932'))
+
+    supplementary = sorted((code, cp) for code, cp in GB18030_2022_TWO_BYTE.items() if cp > 0xFFFF)
+    print(f'const Gb18030Supplementary kGb18030TwoByteSupplementary[{len(supplementary)}] = {{')
+    for code, cp in supplementary:
+        print(f'    {{0x{code:04X}, 0x{cp:05X}}},')
+    print('};')
+    print()
+
+    ranges = gb18030_ranges()
+    print(f'const Gb18030Range kGb18030Ranges[{len(ranges)}] = {{')
+    for index, length, cp in ranges:
+        print(f'    {{{index}, {length}, 0x{cp:04X}}},')
+    print('};')
+    print()
+    print('}')
+
+
+if __name__ == '__main__':
+    main()